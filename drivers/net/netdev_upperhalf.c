@@ -34,11 +34,13 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
+#include <nuttx/lib/math32.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/can.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/net/vlan.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
@@ -51,6 +53,26 @@
 
 #define NETDEV_THREAD_NAME_FMT "netdev-%s"
 
+/* Number of entries of the RSS indirection table of multi-queue devices */
+
+#define NETDEV_RSS_TABLE_SIZE 128
+
+/* The number of segments the largest GSO packet is split into, with the
+ * headers of the family giving the smallest segments.
+ */
+
+#ifdef CONFIG_NETDEV_GSO
+#  ifdef CONFIG_NET_IPv6
+#    define NETDEV_GSO_HDRLEN IPv6TCP_HDRLEN
+#  else
+#    define NETDEV_GSO_HDRLEN IPv4TCP_HDRLEN
+#  endif
+
+#  define NETDEV_GSO_NSEGS(d) \
+     div_round_up(CONFIG_NETDEV_GSO_MAXSIZE - NETDEV_GSO_HDRLEN, \
+                  NETDEV_PKTSIZE(d) - NET_LL_HDRLEN(d) - NETDEV_GSO_HDRLEN)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,6 +92,30 @@ struct netdev_thread_s
   sem_t sem_exit;
 };
 
+/* This structure describes the state of a TX/RX queue pair of a
+ * multi-queue device.
+ */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+struct netdev_upperhalf_s;
+struct netdev_queue_s
+{
+  FAR struct netdev_upperhalf_s *upper;
+  struct work_s work;         /* Poll of the queue */
+  int cpu;                    /* The CPU polling the queue */
+#ifdef CONFIG_SCHED_PCPUWORK
+  bool fallback;              /* work is on the driver's work queue */
+#endif
+
+#if CONFIG_IOB_NCHAINS > 0
+  /* Received packets steered to the queue by the other queues */
+
+  struct iob_queue_s rxq;
+  spinlock_t lock;            /* Protects rxq */
+#endif
+};
+#endif
+
 /* This structure describes the state of the upper half driver */
 
 struct netdev_upperhalf_s
@@ -82,12 +128,38 @@ struct netdev_upperhalf_s
   struct iob_queue_s txq;
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+  /* Segments of a GSO packet waiting for TX quota */
+
+  struct iob_queue_s gsoq;
+#endif
+
 #ifdef CONFIG_NET_VLAN
   struct netdev_vlan_entry_s vlan[CONFIG_NET_VLAN_COUNT];
 #endif
 
   bool txing;
 
+#ifdef CONFIG_SCHED_PCPUWORK
+  /* NETDEV_RX_WORK_RSS: The CPU reading the sockets as notified by
+   * netdev_notify_recvcpu() (-1 if unknown) and the CPU the work is queued
+   * on (-1 if it is queued on the driver's work queue).
+   */
+
+  int rxcpu;
+  int workcpu;
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Multi-queue devices: The state of the queues (NULL if the device has a
+   * single queue), and the RSS indirection table giving the queue the
+   * flows are steered to by their hash.
+   */
+
+  FAR struct netdev_queue_s *queue;
+  uint8_t rss_table[NETDEV_RSS_TABLE_SIZE];
+#endif
+
   /* Deferring process to work queue or thread */
 
   union
@@ -102,6 +174,10 @@ struct netdev_upperhalf_s
  ****************************************************************************/
 
 static int netdev_upper_txavail(FAR struct net_driver_s *dev);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static void netdev_upper_queue_rxq(FAR struct netdev_upperhalf_s *upper,
+                                   int qid);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -241,19 +317,485 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev, size_t extra_size)
  *
  ****************************************************************************/
 
-static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
+static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int quota = netdev_lower_quota_load(lower, NETPKT_TX);
+
+  if (quota <= 0 && lower->ops->reclaim)
+    {
+      lower->ops->reclaim(lower);
+      quota = netdev_lower_quota_load(lower, NETPKT_TX);
+    }
+
+  return quota > 0;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_flow_hash
+ *
+ * Description:
+ *   Get the RSS hash of the flow of a TCP or UDP packet.  The TX packets
+ *   are hashed as the RX packets of the flow, so that a flow is sent on the
+ *   queue it is received on.
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *   pkt  - The packet, starting at the IP header
+ *   rx   - true if the packet is received, false if it is sent
+ *   hash - Location to return the hash
+ *
+ * Returned Value:
+ *   true if the hash is returned, false if the packet is not of a TCP or
+ *   UDP flow.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static bool netdev_upper_flow_hash(FAR struct net_driver_s *dev,
+                                   FAR netpkt_t *pkt, bool rx,
+                                   FAR uint32_t *hash)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR const void *src;
+  FAR const void *dst;
+  unsigned int iphdrlen;
+  uint16_t sport;
+  uint16_t dport;
+  uint8_t domain;
+  uint8_t proto;
+
+  if (dev->d_lltype == NET_LL_ETHERNET || dev->d_lltype == NET_LL_LOOPBACK ||
+      dev->d_lltype == NET_LL_IEEE80211)
+    {
+      FAR struct eth_hdr_s *eth =
+                              (FAR struct eth_hdr_s *)(ip - ETH_HDRLEN);
+
+      if (eth->type != HTONS(ETHTYPE_IP) && eth->type != HTONS(ETHTYPE_IP6))
+        {
+          return false;
+        }
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      /* Only the first fragment has the ports, leave the fragments on the
+       * queue they come from.
+       */
+
+      if ((ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
+        {
+          return false;
+        }
+
+      iphdrlen = (ip[0] & IPv4_HLMASK) << 2;
+      domain   = PF_INET;
+      proto    = ipv4->proto;
+      src      = ipv4->srcipaddr;
+      dst      = ipv4->destipaddr;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      iphdrlen = IPv6_HDRLEN;
+      domain   = PF_INET6;
+      proto    = ipv6->proto;
+      src      = ipv6->srcipaddr;
+      dst      = ipv6->destipaddr;
+    }
+  else
+#endif
+    {
+      return false;
+    }
+
+  if ((proto != IP_PROTO_TCP && proto != IP_PROTO_UDP) ||
+      pkt->io_len < iphdrlen + 2 * sizeof(uint16_t))
+    {
+      return false;
+    }
+
+  memcpy(&sport, ip + iphdrlen, sizeof(uint16_t));
+  memcpy(&dport, ip + iphdrlen + sizeof(uint16_t), sizeof(uint16_t));
+
+  if (rx)
+    {
+      *hash = netdev_rss_hash(domain, src, sport, dst, dport);
+    }
+  else
+    {
+      *hash = netdev_rss_hash(domain, dst, dport, src, sport);
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_tx_queue
+ *
+ * Description:
+ *   Get the queue to send a packet on: the queue the RX packets of its flow
+ *   are steered to, or the first queue for the packets of no flow.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The packet to be sent
+ *
+ * Returned Value:
+ *   The index of the queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int netdev_upper_tx_queue(FAR struct netdev_upperhalf_s *upper,
+                                 FAR netpkt_t *pkt)
+{
+  uint32_t hash;
+
+  if (upper->queue != NULL &&
+      netdev_upper_flow_hash(&upper->lower->netdev, pkt, false, &hash))
+    {
+      return upper->rss_table[hash % NETDEV_RSS_TABLE_SIZE];
+    }
+
+  return 0;
+}
+#else
+#  define netdev_upper_tx_queue(upper, pkt) 0
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_transmit
+ *
+ * Description:
+ *   Hand a packet to the lower half, on a queue of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   qid - The queue to send the packet on
+ *   pkt - The packet to be sent
+ *
+ * Returned Value:
+ *   The value returned by the lower half.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_transmit(FAR struct net_driver_s *dev, int qid,
+                                 FAR netpkt_t *pkt)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (upper->queue != NULL)
+    {
+#ifdef CONFIG_NETDEV_STATISTICS
+      dev->d_qstatistics[qid].tx_packets++;
+      dev->d_qstatistics[qid].tx_bytes += netpkt_getdatalen(lower, pkt);
+#endif
+
+      return lower->ops->transmitq(lower, qid, pkt);
+    }
+#endif
+
+  return lower->ops->transmit(lower, pkt);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_hdrlen
+ *
+ * Description:
+ *   Get the length of the IP and TCP headers of a TCP packet built above
+ *   the MTU.
+ *
+ * Input Parameters:
+ *   pkt      - The packet to be segmented
+ *   iphdrlen - Location to return the length of the IP header
+ *
+ * Returned Value:
+ *   The length of the IP and TCP headers, or 0 if the packet is not TCP.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+static unsigned int netdev_upper_gso_hdrlen(FAR netpkt_t *pkt,
+                                            FAR unsigned int *iphdrlen)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *tcp;
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION &&
+      ((FAR struct ipv4_hdr_s *)ip)->proto == IP_PROTO_TCP)
+    {
+      *iphdrlen = (ip[0] & IPv4_HLMASK) << 2;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & IP_VERSION_MASK) == IPv6_VERSION &&
+      ((FAR struct ipv6_hdr_s *)ip)->proto == IP_PROTO_TCP)
+    {
+      *iphdrlen = IPv6_HDRLEN;
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  tcp = (FAR struct tcp_hdr_s *)(ip + *iphdrlen);
+  return *iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso
+ *
+ * Description:
+ *   Split a TCP packet built above the MTU into segments and transmit
+ *   them.  The headers of the packet are updated for every segment and
+ *   copied with the payload of the segment into a new packet.  Every
+ *   segment takes its own TX quota, the segments left when it runs out
+ *   are queued and sent by netdev_upper_tx() once the driver is done with
+ *   the previous ones.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   qid - The queue to send the segments on
+ *   pkt - The packet to be segmented
+ *
+ * Returned Value:
+ *   OK if all segments are sent or queued and the packet is freed, a
+ *   negated errno value otherwise.  The packet is still owned by the caller
+ *   on failure, its segments not sent yet are retransmitted by TCP.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_gso(FAR struct net_driver_s *dev, int qid,
+                            FAR netpkt_t *pkt)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct tcp_hdr_s          *tcp;
+  FAR netpkt_t                  *seg;
+  unsigned int                   iphdrlen;
+  unsigned int                   hdrlen;
+  unsigned int                   segsize;
+  unsigned int                   offset;
+  unsigned int                   len;
+  uint32_t                       seqno;
+  uint32_t                       nseqno;
+  uint8_t                        flags;
+  int                            ret = -EMSGSIZE;
+
+  hdrlen = netdev_upper_gso_hdrlen(pkt, &iphdrlen);
+  if (hdrlen == 0 || pkt->io_len < hdrlen)
+    {
+      nerr("ERROR: Packet too long to send!\n");
+      return ret;
+    }
+
+  if ((dev->d_features & NETDEV_TX_TSO) != 0)
+    {
+      /* The hardware segments the packet */
+
+      return netdev_upper_transmit(dev, qid, pkt);
+    }
+
+  segsize = NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - hdrlen;
+  tcp     = (FAR struct tcp_hdr_s *)(IOB_DATA(pkt) + iphdrlen);
+  flags   = tcp->flags;
+
+  memcpy(&seqno, tcp->seqno, sizeof(seqno));
+  seqno = NTOHL(seqno);
+
+  for (offset = hdrlen; offset < pkt->io_pktlen; offset += len)
+    {
+      len = MIN(segsize, pkt->io_pktlen - offset);
+
+      /* FIN and PSH only belong to the last segment */
+
+      tcp->flags = flags;
+      if (offset + len < pkt->io_pktlen)
+        {
+          tcp->flags &= ~(TCP_FIN | TCP_PSH);
+        }
+
+      nseqno = HTONL(seqno + offset - hdrlen);
+      memcpy(tcp->seqno, &nseqno, sizeof(nseqno));
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_IPv4
+      if ((IOB_DATA(pkt)[0] & IP_VERSION_MASK) == IPv4_VERSION)
+        {
+          FAR struct ipv4_hdr_s *ipv4 =
+            (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+
+          /* Give every segment its own IP identification */
+
+          if (offset > hdrlen)
+            {
+              uint16_t ipid = (ipv4->ipid[0] << 8) + ipv4->ipid[1] + 1;
+
+              ipv4->ipid[0] = ipid >> 8;
+              ipv4->ipid[1] = ipid & 0xff;
+            }
+
+          ipv4->len[0]   = (hdrlen + len) >> 8;
+          ipv4->len[1]   = (hdrlen + len) & 0xff;
+          ipv4->ipchksum = 0;
+          ipv4->ipchksum = ~ipv4_chksum(ipv4);
+        }
+#endif
+#ifdef CONFIG_NET_IPv6
+      if ((IOB_DATA(pkt)[0] & IP_VERSION_MASK) == IPv6_VERSION)
+        {
+          FAR struct ipv6_hdr_s *ipv6 =
+            (FAR struct ipv6_hdr_s *)IOB_DATA(pkt);
+
+          ipv6->len[0] = (hdrlen + len - IPv6_HDRLEN) >> 8;
+          ipv6->len[1] = (hdrlen + len - IPv6_HDRLEN) & 0xff;
+        }
+#endif
+
+      /* Copy the L2 header, the updated IP and TCP headers and the payload
+       * of the segment.
+       */
+
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
+        {
+          ret = -ENOMEM;
+          break;
+        }
+
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+      memcpy(IOB_DATA(seg) - NET_LL_HDRLEN(dev),
+             IOB_DATA(pkt) - NET_LL_HDRLEN(dev), NET_LL_HDRLEN(dev));
+
+      ret = iob_clone_partial(pkt, hdrlen, 0, seg, 0, false, false);
+      if (ret == OK)
+        {
+          ret = iob_clone_partial(pkt, len, offset, seg, hdrlen,
+                                  false, false);
+        }
+
+      if (ret != OK)
+        {
+          iob_free_chain(seg);
+          break;
+        }
+
+      netdev_iob_replace_l2(dev, seg);
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+        {
+          FAR struct tcp_hdr_s *segtcp = IPBUF(iphdrlen);
+
+#ifdef CONFIG_NET_IPv4
+          if ((IOB_DATA(seg)[0] & IP_VERSION_MASK) == IPv4_VERSION)
+            {
+              segtcp->tcpchksum = ~ipv4_upperlayer_chksum(dev,
+                                                          IP_PROTO_TCP);
+            }
+#endif
+#ifdef CONFIG_NET_IPv6
+          if ((IOB_DATA(seg)[0] & IP_VERSION_MASK) == IPv6_VERSION)
+            {
+              segtcp->tcpchksum = ~ipv6_upperlayer_chksum(dev,
+                                                          IP_PROTO_TCP,
+                                                          IPv6_HDRLEN);
+            }
+#endif
+        }
+#endif
+
+      if (IOB_QEMPTY(&upper->gsoq) && netdev_upper_can_tx(upper))
+        {
+          seg = netpkt_get(dev, NETPKT_TX);
+          ret = netdev_upper_transmit(dev, qid, seg);
+          if (ret != OK)
+            {
+              netpkt_free(lower, seg, NETPKT_TX);
+              break;
+            }
+        }
+      else
+        {
+          netdev_iob_clear(dev);
+          ret = iob_tryadd_queue(seg, &upper->gsoq);
+          if (ret < 0)
+            {
+              iob_free_chain(seg);
+              break;
+            }
+
+          ret = OK;
+        }
+    }
+
+  if (ret == OK)
+    {
+      netpkt_free(lower, pkt, NETPKT_TX);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_drain
+ *
+ * Description:
+ *   Transmit the next segment queued by netdev_upper_gso().
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_gso_drain(FAR struct net_driver_s *dev)
 {
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  int quota = netdev_lower_quota_load(lower, NETPKT_TX);
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR netpkt_t                  *seg;
+  int                            ret;
 
-  if (quota <= 0 && lower->ops->reclaim)
+  netdev_iob_replace_l2(dev, iob_remove_queue(&upper->gsoq));
+
+  seg = netpkt_get(dev, NETPKT_TX);
+  ret = netdev_upper_transmit(dev, netdev_upper_tx_queue(upper, seg), seg);
+  if (ret != OK)
     {
-      lower->ops->reclaim(lower);
-      quota = netdev_lower_quota_load(lower, NETPKT_TX);
+      NETDEV_TXERRORS(dev);
+      nerr("ERROR: Transmit failed: %d\n", ret);
+      netpkt_free(upper->lower, seg, NETPKT_TX);
+      return ret;
     }
 
-  return quota > 0;
+  return NETDEV_TX_CONTINUE;
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_txpoll
@@ -285,6 +827,7 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR netpkt_t                  *pkt;
+  int                            qid;
   int                            ret;
 
   DEBUGASSERT(dev->d_len > 0);
@@ -298,15 +841,20 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 #endif
 
   pkt = netpkt_get(dev, NETPKT_TX);
+  qid = netdev_upper_tx_queue(upper, pkt);
 
   if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
     {
+#ifdef CONFIG_NETDEV_GSO
+      ret = netdev_upper_gso(dev, qid, pkt);
+#else
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
+#endif
     }
   else
     {
-      ret = lower->ops->transmit(lower, pkt);
+      ret = netdev_upper_transmit(dev, qid, pkt);
     }
 
   if (ret != OK)
@@ -348,6 +896,15 @@ static int netdev_upper_tx(FAR struct net_driver_s *dev)
 #if CONFIG_IOB_NCHAINS > 0
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* The segments of the last GSO packet go first to keep them in order */
+
+  if (!IOB_QEMPTY(&upper->gsoq))
+    {
+      return netdev_upper_gso_drain(dev);
+    }
+#endif
+
   if (!IOB_QEMPTY(&upper->txq))
     {
       /* Put the packet back to the device */
@@ -688,83 +1245,459 @@ static void ip_input(FAR struct net_driver_s *dev)
 #endif
 
 /****************************************************************************
- * Function: netdev_upper_rxpoll_work
+ * Name: netdev_upper_input
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   Pass a received packet to the network stack.
  *
  * Input Parameters:
- *   upper - Reference to the upper half driver structure
+ *   dev - Reference to the NuttX network driver state structure
+ *   pkt - The received packet
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static void netdev_upper_input(FAR struct net_driver_s *dev,
+                               FAR netpkt_t *pkt)
 {
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR struct net_driver_s       *dev   = &lower->netdev;
-  FAR netpkt_t                  *pkt;
-
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
-
-  netdev_lock(dev);
-  while ((pkt = lower->ops->receive(lower)) != NULL)
-    {
-      if (!IFF_IS_UP(dev->d_flags))
-        {
-          /* Interface down, drop frame */
-
-          NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
-          nerr("ERROR: Dropped frame due to lower dev not up\n");
-          continue;
-        }
-
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
 
 #ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+  /* When packet sockets are enabled, feed the frame into the tap */
 
-      pkt_input(dev);
+  pkt_input(dev);
 #endif
 
-      switch (dev->d_lltype)
-        {
+  switch (dev->d_lltype)
+    {
 #ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
+    case NET_LL_LOOPBACK:
 #endif
 #ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
+    case NET_LL_ETHERNET:
 #endif
 #ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
+    case NET_LL_IEEE80211:
 #endif
 #if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
     defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
+      eth_input(dev);
+      break;
 #endif
 #ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
 #endif
 #ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
 #endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_check
+ *
+ * Description:
+ *   Check if a received Ethernet frame may be merged with others: an IPv4
+ *   packet without options or fragmentation carrying a TCP segment with
+ *   data and only the ACK and PSH flags.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *   pkt - The received packet
+ *
+ * Returned Value:
+ *   true if the packet may be merged.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+static bool netdev_upper_gro_check(FAR struct net_driver_s *dev,
+                                   FAR netpkt_t *pkt)
+{
+  FAR struct eth_hdr_s *eth;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int tcphdrlen;
+  unsigned int iplen;
+
+  if (dev->d_lltype != NET_LL_ETHERNET ||
+      pkt->io_len < IPv4_HDRLEN + TCP_HDRLEN)
+    {
+      return false;
+    }
+
+  eth  = (FAR struct eth_hdr_s *)(IOB_DATA(pkt) - ETH_HDRLEN);
+  ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+  tcp  = (FAR struct tcp_hdr_s *)(IOB_DATA(pkt) + IPv4_HDRLEN);
+
+  if (eth->type != HTONS(ETHTYPE_IP) ||
+      ipv4->vhl != (IPv4_VERSION | (IPv4_HDRLEN >> 2)) ||
+      ipv4->proto != IP_PROTO_TCP ||
+      (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
+    {
+      return false;
+    }
+
+  iplen     = (ipv4->len[0] << 8) + ipv4->len[1];
+  tcphdrlen = (tcp->tcpoffset >> 4) << 2;
+
+  return tcphdrlen >= TCP_HDRLEN &&
+         pkt->io_len >= IPv4_HDRLEN + tcphdrlen &&
+         iplen > IPv4_HDRLEN + tcphdrlen && iplen <= pkt->io_pktlen &&
+         (tcp->flags & TCP_CTL & ~TCP_PSH) == TCP_ACK;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_merge
+ *
+ * Description:
+ *   Append the payload of a received TCP segment to the held one if it is
+ *   the next in-order segment of the same connection.
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX network driver state structure
+ *   held - The held packet
+ *   pkt  - The received packet
+ *
+ * Returned Value:
+ *   true if the packet is merged and freed.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_merge(FAR struct net_driver_s *dev,
+                                   FAR netpkt_t *held, FAR netpkt_t *pkt)
+{
+  FAR struct ipv4_hdr_s *hipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(held);
+  FAR struct ipv4_hdr_s *ipv4  = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+  FAR struct tcp_hdr_s  *htcp  =
+    (FAR struct tcp_hdr_s *)(IOB_DATA(held) + IPv4_HDRLEN);
+  FAR struct tcp_hdr_s  *tcp   =
+    (FAR struct tcp_hdr_s *)(IOB_DATA(pkt) + IPv4_HDRLEN);
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  unsigned int tcphdrlen = (tcp->tcpoffset >> 4) << 2;
+  unsigned int hiplen;
+  unsigned int iplen;
+  uint32_t hseqno;
+  uint32_t seqno;
+
+  hiplen = (hipv4->len[0] << 8) + hipv4->len[1];
+  iplen  = (ipv4->len[0] << 8) + ipv4->len[1];
+
+  memcpy(&hseqno, htcp->seqno, sizeof(hseqno));
+  memcpy(&seqno, tcp->seqno, sizeof(seqno));
+
+  /* A PSH ends the merged segment, options like timestamps must match */
+
+  if (htcp->flags != TCP_ACK ||
+      htcp->tcpoffset != tcp->tcpoffset ||
+      hipv4->tos != ipv4->tos || hipv4->ttl != ipv4->ttl ||
+      memcmp(hipv4->srcipaddr, ipv4->srcipaddr,
+             2 * sizeof(in_addr_t)) != 0 ||
+      memcmp(htcp, tcp, offsetof(struct tcp_hdr_s, seqno)) != 0 ||
+      memcmp(htcp->ackno, tcp->ackno, sizeof(tcp->ackno)) != 0 ||
+      memcmp(htcp->wnd, tcp->wnd, sizeof(tcp->wnd)) != 0 ||
+      memcmp(htcp->optdata, tcp->optdata, tcphdrlen - TCP_HDRLEN) != 0 ||
+      NTOHL(seqno) != NTOHL(hseqno) + hiplen - IPv4_HDRLEN - tcphdrlen ||
+      hiplen + iplen - IPv4_HDRLEN - tcphdrlen > CONFIG_NETDEV_GRO_MAXSIZE)
+    {
+      return false;
+    }
+
+  /* Drop the Ethernet padding and the headers of the new segment, then
+   * chain its payload to the held one.
+   */
+
+  if (held->io_pktlen > hiplen)
+    {
+      iob_trimtail(held, held->io_pktlen - hiplen);
+    }
+
+  if (pkt->io_pktlen > iplen)
+    {
+      iob_trimtail(pkt, pkt->io_pktlen - iplen);
+    }
+
+  htcp->flags |= tcp->flags;
+  pkt = iob_trimhead(pkt, IPv4_HDRLEN + tcphdrlen);
+  iob_concat(held, pkt);
+
+  hiplen          = held->io_pktlen;
+  hipv4->len[0]   = hiplen >> 8;
+  hipv4->len[1]   = hiplen & 0xff;
+  hipv4->ipchksum = 0;
+  hipv4->ipchksum = ~ipv4_chksum(hipv4);
+
+  /* The driver gets back the quota of the merged packet, its bytes are
+   * counted with the held packet.
+   */
+
+  atomic_fetch_add(&upper->lower->quota_ptr[NETPKT_RX], 1);
+#ifdef CONFIG_NETDEV_STATISTICS
+  dev->d_statistics.rx_packets++;
+#endif
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro
+ *
+ * Description:
+ *   Hold a received TCP segment to merge the following segments of the
+ *   same connection into it, and pass the held segment to the stack once
+ *   a packet can't be merged.
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX network driver state structure
+ *   held - The held packet, updated by this function
+ *   pkt  - The received packet
+ *
+ * Returned Value:
+ *   true if the packet is held or merged, false if the caller must pass
+ *   it to the stack.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro(FAR struct net_driver_s *dev,
+                             FAR netpkt_t **held, FAR netpkt_t *pkt)
+{
+  bool merge = netdev_upper_gro_check(dev, pkt);
+
+  if (*held != NULL)
+    {
+      if (merge && netdev_upper_gro_merge(dev, *held, pkt))
+        {
+          return true;
+        }
+
+      netdev_upper_input(dev, *held);
+      *held = NULL;
+    }
+
+  if (merge)
+    {
+      *held = pkt;
+    }
+
+  return merge;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_rss_steer
+ *
+ * Description:
+ *   Pass a packet received on a queue of a multi-queue device to the queue
+ *   its flow is steered to by the RSS indirection table, unless the
+ *   hardware steers the flows itself.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   qid   - The queue the packet is received on
+ *   pkt   - The received packet
+ *
+ * Returned Value:
+ *   true if the packet is passed to another queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static bool netdev_upper_rss_steer(FAR struct netdev_upperhalf_s *upper,
+                                   int qid, FAR netpkt_t *pkt)
+{
+#if CONFIG_IOB_NCHAINS > 0
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR struct netdev_queue_s *queue;
+  irqstate_t flags;
+  uint32_t hash;
+  int target;
+  int ret;
+
+  /* Leave the packets on their queue if the hardware steers the flows, or
+   * if they are polled in the context of the interrupt of the queue.
+   */
+
+  if ((dev->d_features & NETDEV_RX_RSS) != 0 ||
+      upper->lower->rxtype == NETDEV_RX_DIRECT ||
+      !netdev_upper_flow_hash(dev, pkt, true, &hash))
+    {
+      return false;
+    }
+
+  target = upper->rss_table[hash % NETDEV_RSS_TABLE_SIZE];
+  if (target == qid)
+    {
+      return false;
+    }
+
+  queue = &upper->queue[target];
+  flags = spin_lock_irqsave(&queue->lock);
+  ret   = iob_tryadd_queue(pkt, &queue->rxq);
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  if (ret < 0)
+    {
+      /* Out of queue entries, process the packet on this queue */
+
+      return false;
+    }
+
+#ifdef CONFIG_NETDEV_STATISTICS
+  dev->d_qstatistics[qid].rx_steered++;
+#endif
+
+  netdev_upper_queue_rxq(upper, target);
+  return true;
+#else
+  return false;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_receive
+ *
+ * Description:
+ *   Get the next packet to pass to the network stack: from the lower half,
+ *   or for a queue of a multi-queue device, the packets steered to it by
+ *   the other queues first, then the ones of the flows of the queue
+ *   received by the lower half.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   qid   - The queue to receive from
+ *
+ * Returned Value:
+ *   The received packet, or NULL if no more packets.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_upperhalf_s *upper, int qid)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR netpkt_t                  *pkt;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (upper->queue != NULL)
+    {
+#if CONFIG_IOB_NCHAINS > 0
+      FAR struct netdev_queue_s *queue = &upper->queue[qid];
+      irqstate_t flags;
+
+      flags = spin_lock_irqsave(&queue->lock);
+      pkt   = iob_remove_queue(&queue->rxq);
+      spin_unlock_irqrestore(&queue->lock, flags);
+
+      if (pkt != NULL)
+        {
+          return pkt;
+        }
+#endif
+
+      while ((pkt = lower->ops->receiveq(lower, qid)) != NULL)
+        {
+#ifdef CONFIG_NETDEV_STATISTICS
+          FAR struct netdev_queue_statistics_s *stats =
+                                       &lower->netdev.d_qstatistics[qid];
+
+          stats->rx_packets++;
+          stats->rx_bytes += netpkt_getdatalen(lower, pkt);
+#endif
+
+          if (!netdev_upper_rss_steer(upper, qid, pkt))
+            {
+              break;
+            }
+        }
+
+      return pkt;
+    }
+#endif
+
+  pkt = lower->ops->receive(lower);
+  return pkt;
+}
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_work
+ *
+ * Description:
+ *   Try to receive packets from device and pass packets into IP
+ *   stack and send packets which is from IP stack if necessary.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   qid   - The queue to receive from (0 for single queue devices)
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     int qid)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+  FAR netpkt_t                  *pkt;
+#ifdef CONFIG_NETDEV_GRO
+  FAR netpkt_t                  *held = NULL;
+  bool                           gro;
+
+  /* Merge TCP segments only if the hardware verified their checksums and
+   * did not merge them already.
+   */
+
+  gro = (dev->d_features & (NETDEV_RX_CSUM | NETDEV_RX_LRO)) ==
+        NETDEV_RX_CSUM;
+#endif
+
+  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+
+  netdev_lock(dev);
+  while ((pkt = netdev_upper_receive(upper, qid)) != NULL)
+    {
+      if (!IFF_IS_UP(dev->d_flags))
+        {
+          /* Interface down, drop frame */
+
+          NETDEV_RXDROPPED(dev);
+          netpkt_free(lower, pkt, NETPKT_RX);
+          nerr("ERROR: Dropped frame due to lower dev not up\n");
+          continue;
+        }
+
+#ifdef CONFIG_NETDEV_GRO
+      if (gro && netdev_upper_gro(dev, &held, pkt))
+        {
+          continue;
         }
+#endif
+
+      netdev_upper_input(dev, pkt);
     }
 
+#ifdef CONFIG_NETDEV_GRO
+  if (held != NULL)
+    {
+      netdev_upper_input(dev, held);
+    }
+#endif
+
   netdev_unlock(dev);
 }
 
@@ -785,9 +1718,32 @@ static void netdev_upper_work(FAR void *arg)
 
   /* RX may release quota and driver buffer, so do RX first. */
 
-  netdev_upper_rxpoll_work(upper);
+  netdev_upper_rxpoll_work(upper, 0);
+  netdev_upper_txavail_work(upper);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_rxq_work
+ *
+ * Description:
+ *   Perform an out-of-cycle poll of a queue of a multi-queue device on the
+ *   worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the queue structure (cast to void *)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static void netdev_upper_rxq_work(FAR void *arg)
+{
+  FAR struct netdev_queue_s *queue = arg;
+  FAR struct netdev_upperhalf_s *upper = queue->upper;
+
+  netdev_upper_rxpoll_work(upper, queue - upper->queue);
   netdev_upper_txavail_work(upper);
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_loop
@@ -839,6 +1795,14 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   int cpu = 0;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (upper->queue != NULL)
+    {
+      netdev_upper_queue_rxq(upper, 0);
+      return;
+    }
+#endif
+
   switch (upper->lower->rxtype)
     {
       case NETDEV_RX_WORK:
@@ -853,6 +1817,30 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
             }
         }
         break;
+#ifdef CONFIG_SCHED_PCPUWORK
+      case NETDEV_RX_WORK_RSS:
+        {
+          FAR struct work_s *work = upper->work;
+          if (work_available(work))
+            {
+              /* Poll on the CPU that reads the sockets, or on the CPU
+               * that took the interrupt until that one is known.
+               */
+
+              cpu = upper->rxcpu >= 0 ? upper->rxcpu : this_cpu();
+              upper->workcpu = cpu;
+              if (work_queue_on(cpu, work, netdev_upper_work, upper, 0) < 0)
+                {
+                  /* The work queue of the CPU is not running */
+
+                  upper->workcpu = -1;
+                  work_queue(upper->lower->priority, work,
+                             netdev_upper_work, upper, 0);
+                }
+            }
+        }
+        break;
+#endif
       case NETDEV_RX_THREAD_RSS:
         cpu = this_cpu();
       case NETDEV_RX_THREAD:
@@ -869,6 +1857,45 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: netdev_upper_queue_rxq
+ *
+ * Description:
+ *   Called when there is any work to do on a queue of a multi-queue device.
+ *   The work of the queue runs on the CPU of the queue if the CPUs have
+ *   their own work queues.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   qid   - The queue with work to do
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static void netdev_upper_queue_rxq(FAR struct netdev_upperhalf_s *upper,
+                                   int qid)
+{
+  FAR struct netdev_queue_s *queue = &upper->queue[qid];
+
+  if (work_available(&queue->work))
+    {
+#ifdef CONFIG_SCHED_PCPUWORK
+      /* The work queue of the CPU may not be running */
+
+      queue->fallback = work_queue_on(queue->cpu, &queue->work,
+                                      netdev_upper_rxq_work, queue, 0) < 0;
+      if (!queue->fallback)
+        {
+          return;
+        }
+#endif
+
+      work_queue(upper->lower->priority, &queue->work,
+                 netdev_upper_rxq_work, queue, 0);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_txavail
  *
@@ -1260,11 +2287,45 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (upper->queue != NULL)
+    {
+      int qid;
+
+      for (qid = 0; qid < dev->d_nqueues; qid++)
+        {
+          FAR struct netdev_queue_s *queue = &upper->queue[qid];
+
+#ifdef CONFIG_SCHED_PCPUWORK
+          if (!queue->fallback)
+            {
+              work_cancel_sync_on(queue->cpu, &queue->work);
+              continue;
+            }
+#endif
+
+          work_cancel_sync(upper->lower->priority, &queue->work);
+        }
+    }
+#endif
+
   switch (upper->lower->rxtype)
     {
       case NETDEV_RX_WORK:
         work_cancel_sync(upper->lower->priority, upper->work);
         break;
+#ifdef CONFIG_SCHED_PCPUWORK
+      case NETDEV_RX_WORK_RSS:
+        if (upper->workcpu < 0)
+          {
+            work_cancel_sync(upper->lower->priority, upper->work);
+          }
+        else
+          {
+            work_cancel_sync_on(upper->workcpu, upper->work);
+          }
+        break;
+#endif
       case NETDEV_RX_THREAD:
       case NETDEV_RX_THREAD_RSS:
         netdev_upper_exit_thread(upper);
@@ -1336,6 +2397,59 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
     }
 #endif
 
+#if defined(CONFIG_SCHED_PCPUWORK) && defined(CONFIG_NETDEV_RSS)
+  /* Steer the RX work to the CPU reading the sockets.  The lower half may
+   * still use the notification to program its hardware RSS.
+   */
+
+  if (cmd == SIOCNOTIFYRECVCPU && lower->rxtype == NETDEV_RX_WORK_RSS)
+    {
+      FAR struct netdev_rss_s *rss =
+                                (FAR struct netdev_rss_s *)(uintptr_t)arg;
+
+      if (rss->cpu >= 0 && rss->cpu < CONFIG_SMP_NCPUS)
+        {
+          upper->rxcpu = rss->cpu;
+        }
+
+      ret = OK;
+
+      if (lower->ops->ioctl)
+        {
+          ret = lower->ops->ioctl(lower, cmd, arg);
+        }
+
+      return ret == -ENOTTY ? OK : ret;
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Steer the flow to the queue polled by the CPU reading the sockets,
+   * the lower half may still use the notification to program its hardware
+   * RSS.
+   */
+
+  if (cmd == SIOCNOTIFYRECVCPU && upper->queue != NULL)
+    {
+      FAR struct netdev_rss_s *rss =
+                                (FAR struct netdev_rss_s *)(uintptr_t)arg;
+
+      if (rss->cpu >= 0 && rss->cpu < dev->d_nqueues)
+        {
+          upper->rss_table[rss->hash % NETDEV_RSS_TABLE_SIZE] = rss->cpu;
+        }
+
+      ret = OK;
+
+      if (lower->ops->ioctl)
+        {
+          ret = lower->ops->ioctl(lower, cmd, arg);
+        }
+
+      return ret == -ENOTTY ? OK : ret;
+    }
+#endif
+
   if (lower->ops->ioctl)
     {
       return lower->ops->ioctl(lower, cmd, arg);
@@ -1345,6 +2459,63 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_upper_queue_alloc/free
+ *
+ * Description:
+ *   Allocate and free the state of the queues of a multi-queue device.
+ *   The queues are polled by the CPUs in turn and the flows are spread
+ *   over them by the RSS indirection table until the sockets reading them
+ *   tell their CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int netdev_upper_queue_alloc(FAR struct netdev_upperhalf_s *upper)
+{
+  int nqueues = upper->lower->netdev.d_nqueues;
+  int i;
+
+  upper->queue = kmm_zalloc(sizeof(struct netdev_queue_s) * nqueues);
+  if (upper->queue == NULL)
+    {
+      nerr("ERROR: Queue allocation failed\n");
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nqueues; i++)
+    {
+      upper->queue[i].upper = upper;
+      upper->queue[i].cpu   = i % CONFIG_SMP_NCPUS;
+#if CONFIG_IOB_NCHAINS > 0
+      spin_lock_init(&upper->queue[i].lock);
+#endif
+    }
+
+  for (i = 0; i < NETDEV_RSS_TABLE_SIZE; i++)
+    {
+      upper->rss_table[i] = i % nqueues;
+    }
+
+  return OK;
+}
+
+static void netdev_upper_queue_free(FAR struct netdev_upperhalf_s *upper)
+{
+#if CONFIG_IOB_NCHAINS > 0
+  int i;
+
+  for (i = 0; i < upper->lower->netdev.d_nqueues; i++)
+    {
+      iob_free_queue(&upper->queue[i].rxq);
+    }
+#endif
+
+  kmm_free(upper->queue);
+  upper->queue = NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1374,8 +2545,29 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   int cpu = 0;
   int ret;
 
-  if (dev == NULL || dev->ops == NULL ||
-      dev->ops->transmit == NULL || dev->ops->receive == NULL)
+  if (dev == NULL || dev->ops == NULL)
+    {
+      nerr("ERROR: Invalid lower half device\n");
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->netdev.d_nqueues > 1)
+    {
+      /* The queues are polled by their own work or in their interrupt */
+
+      if (dev->netdev.d_nqueues > CONFIG_NETDEV_MAX_QUEUES ||
+          dev->ops->transmitq == NULL || dev->ops->receiveq == NULL ||
+          (dev->rxtype != NETDEV_RX_WORK &&
+           dev->rxtype != NETDEV_RX_DIRECT))
+        {
+          nerr("ERROR: Invalid multi-queue lower half device\n");
+          return -EINVAL;
+        }
+    }
+  else
+#endif
+  if (dev->ops->transmit == NULL || dev->ops->receive == NULL)
     {
       nerr("ERROR: Invalid lower half device\n");
       return -EINVAL;
@@ -1407,6 +2599,11 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
         extra_size = sizeof(struct netdev_thread_s) * CONFIG_SMP_NCPUS;
         cpu = CONFIG_SMP_NCPUS;
         break;
+#ifdef CONFIG_SCHED_PCPUWORK
+      case NETDEV_RX_WORK_RSS:
+        extra_size = sizeof(struct work_s);
+        break;
+#endif
       default:
         nerr("ERROR: Unrecognized device rxtype: %d\n", dev->rxtype);
         return -EINVAL;
@@ -1419,6 +2616,28 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 
   upper->txing = false;
 
+#ifdef CONFIG_SCHED_PCPUWORK
+  /* The RX work follows the interrupt until the CPU reading the sockets is
+   * notified, no work is queued on any CPU yet.
+   */
+
+  upper->rxcpu   = -1;
+  upper->workcpu = this_cpu();
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->netdev.d_nqueues > 1)
+    {
+      ret = netdev_upper_queue_alloc(upper);
+      if (ret < 0)
+        {
+          kmm_free(upper);
+          dev->netdev.d_private = NULL;
+          return ret;
+        }
+    }
+#endif
+
   dev->netdev.d_ifup    = netdev_upper_ifup;
   dev->netdev.d_ifdown  = netdev_upper_ifdown;
   dev->netdev.d_txavail = netdev_upper_txavail;
@@ -1435,10 +2654,35 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   if (ret < 0)
     {
       nerr("ERROR: Netdev_register failed: %d\n", ret);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      if (upper->queue != NULL)
+        {
+          netdev_upper_queue_free(upper);
+        }
+#endif
+
       kmm_free(upper);
       dev->netdev.d_private = NULL;
     }
 
+#ifdef CONFIG_NETDEV_GSO
+  /* Let TCP build packets above the MTU for drivers segmenting them in
+   * hardware, or with the TX quota for the segments netdev_upper_gso()
+   * splits the largest one into.  Drivers with a smaller TX ring keep
+   * getting packets of the MTU, unless they set NETDEV_TX_GSO themselves.
+   */
+
+  if (ret >= 0 &&
+      ((dev->netdev.d_features & NETDEV_TX_TSO) != 0 ||
+       (NETDEV_PKTSIZE(&dev->netdev) - NET_LL_HDRLEN(&dev->netdev) >
+        NETDEV_GSO_HDRLEN &&
+        netdev_lower_quota_load(dev, NETPKT_TX) >=
+        NETDEV_GSO_NSEGS(&dev->netdev))))
+    {
+      dev->netdev.d_features |= NETDEV_TX_GSO;
+    }
+#endif
+
   while (--cpu >= 0)
     {
       FAR struct netdev_thread_s *t = &upper->thread[cpu];
@@ -1512,6 +2756,17 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
   iob_free_queue(&upper->txq);
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+  iob_free_queue(&upper->gsoq);
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (upper->queue != NULL)
+    {
+      netdev_upper_queue_free(upper);
+    }
+#endif
+
   kmm_free(upper);
   dev->netdev.d_private = NULL;
 
@@ -1585,7 +2840,7 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 
   if (dev->rxtype == NETDEV_RX_DIRECT)
     {
-      netdev_upper_rxpoll_work(dev->netdev.d_private);
+      netdev_upper_rxpoll_work(dev->netdev.d_private, 0);
     }
   else
     {
@@ -1622,6 +2877,76 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
   NETDEV_TXDONE(&dev->netdev);
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about RX packets ready to read on a queue
+ *   of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The queue with packets ready
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev, int qid)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  DEBUGASSERT(upper->queue != NULL && qid < dev->netdev.d_nqueues);
+
+  if (dev->rxtype == NETDEV_RX_DIRECT)
+    {
+      netdev_upper_rxpoll_work(upper, qid);
+    }
+  else
+    {
+      netdev_upper_queue_rxq(upper, qid);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about TX packets sent on a queue of a
+ *   multi-queue device.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The queue with packets sent
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev, int qid)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  DEBUGASSERT(upper->queue != NULL && qid < dev->netdev.d_nqueues);
+
+#ifdef CONFIG_NET_VLAN
+  netdev_upper_vlan_foreach(upper, netdev_lower_txdone);
+#endif
+  if (dev->rxtype == NETDEV_RX_DIRECT)
+    {
+      netdev_upper_txavail_work(upper);
+    }
+  else
+    {
+      netdev_upper_queue_rxq(upper, qid);
+    }
+
+  NETDEV_TXDONE(&dev->netdev);
+#ifdef CONFIG_NETDEV_STATISTICS
+  dev->netdev.d_qstatistics[qid].tx_done++;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_vlan_add
  *
@@ -1969,3 +3294,44 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
   return i;
 }
+
+/****************************************************************************
+ * Name: netpkt_gso_size
+ *
+ * Description:
+ *   Get the payload size of the segments a TCP packet above the MTU is to
+ *   be split into.  Only drivers which set NETDEV_TX_TSO in d_features
+ *   before registering are given such packets, all others get segments
+ *   split by the upper half.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ * Returned Value:
+ *   The payload size of the segments, or 0 if the packet fits the MTU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+unsigned int netpkt_gso_size(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt)
+{
+  unsigned int iphdrlen;
+  unsigned int hdrlen;
+
+  if (netpkt_getdatalen(dev, pkt) <= NETDEV_PKTSIZE(&dev->netdev))
+    {
+      return 0;
+    }
+
+  hdrlen = netdev_upper_gso_hdrlen(pkt, &iphdrlen);
+  if (hdrlen == 0)
+    {
+      return 0;
+    }
+
+  return NETDEV_PKTSIZE(&dev->netdev) - NET_LL_HDRLEN(&dev->netdev) -
+         hdrlen;
+}
+#endif
@@ -455,10 +455,17 @@ static int virtio_mmio_create_virtqueues(FAR struct virtio_device *vdev,
       return -ENOMEM;
     }
 
-  /* Alloc and init the virtqueue */
+  /* Alloc and init the virtqueue, skipping the ones without a name that
+   * the driver does not use
+   */
 
   for (i = 0; i < nvqs; i++)
     {
+      if (names[i] == NULL)
+        {
+          continue;
+        }
+
       ret = virtio_mmio_create_virtqueue(vmdev, i, names[i], callbacks[i]);
       if (ret < 0)
         {
@@ -755,7 +762,8 @@ static int virtio_mmio_interrupt(int irq, FAR void *context, FAR void *arg)
       for (i = 0; i < vmdev->vdev.vrings_num; i++)
         {
           vq = vrings_info[i].vq;
-          if (vq->callback != NULL && virtqueue_nused(vq) > 0)
+          if (vq != NULL && vq->callback != NULL &&
+              virtqueue_nused(vq) > 0)
             {
               vq->callback(vq);
             }
@@ -34,6 +34,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -46,6 +47,14 @@
 /* Virtio net feature bits */
 
 #define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CTRL_VQ  17
+#define VIRTIO_NET_F_MQ       22
+
+/* Virtio net control commands */
+
+#define VIRTIO_NET_CTRL_MQ    4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+#define VIRTIO_NET_OK         0
 
 /* Virtio net header size and packet buffer size */
 
@@ -59,6 +68,22 @@
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+/* Virtqueues of the queue pair qid, the control virtqueue follows the last
+ * pair of the device when it has several.
+ */
+
+#define VIRTIO_NET_RXQ(qid)   ((qid) * VIRTIO_NET_NUM + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(qid)   ((qid) * VIRTIO_NET_NUM + VIRTIO_NET_TX)
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define VIRTIO_NET_MAX_PAIRS CONFIG_NETDEV_MAX_QUEUES
+#  define VIRTIO_NET_MAX_VQS   (VIRTIO_NET_MAX_PAIRS * VIRTIO_NET_NUM + 1)
+#  define VIRTIO_NET_CTRL_LOCK (VIRTIO_NET_MAX_VQS - 1)
+#else
+#  define VIRTIO_NET_MAX_PAIRS 1
+#  define VIRTIO_NET_MAX_VQS   VIRTIO_NET_NUM
+#endif
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
@@ -100,6 +125,20 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* The VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET command, the header and the number of
+ * pairs are read by the device, which writes the ack.
+ */
+
+begin_packed_struct struct virtio_net_ctrl_mq_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
+} end_packed_struct;
+#endif
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -113,12 +152,20 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  spinlock_t                lock[VIRTIO_NET_MAX_VQS];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
   int                       bufnum;    /* TX and RX Buffer number */
+  int                       npairs;    /* Number of TX/RX queue pairs */
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int                       ctrlvq;    /* Index of the control virtqueue */
+#endif
+
+  /* RX buffers filled in the RX virtqueue of each pair */
+
+  uint16_t                  rxnum[VIRTIO_NET_MAX_PAIRS];
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -155,6 +202,12 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt);
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev, int qid,
+                            FAR netpkt_t *pkt);
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int qid);
+#endif
 #ifdef CONFIG_NET_MCASTGROUP
 static int virtio_net_addmac(FAR struct netdev_lowerhalf_s *dev,
                              FAR const uint8_t *mac);
@@ -195,7 +248,11 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  virtio_net_sendq,
+  virtio_net_recvq
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -267,7 +324,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_RX)
     {
       return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
                                        &priv->lock[vq_id]);
@@ -283,14 +340,20 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev, int qid)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(qid)].vq;
   FAR netpkt_t *pkt;
+  int bufnum;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  /* The RX buffers are shared by the queue pairs */
+
+  bufnum = MAX(priv->bufnum / priv->npairs, 1);
+
+  for (i = 0; priv->rxnum[qid] < bufnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -313,23 +376,25 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RXQ(qid));
+      priv->rxnum[qid]++;
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RXQ(qid)]);
     }
 }
 
 /****************************************************************************
- * Name: virtio_net_txfree
+ * Name: virtio_net_txfreeq
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txfreeq(FAR struct netdev_lowerhalf_s *dev, int qid)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_TXQ(qid)].vq;
   FAR struct virtio_net_llhdr_s *hdr;
 
   while (1)
@@ -337,7 +402,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
       /* Get buffer from tx virtqueue */
 
       hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
+                                      &priv->lock[VIRTIO_NET_TXQ(qid)]);
       if (hdr == NULL)
         {
           break;
@@ -348,6 +413,21 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_txfree
+ ****************************************************************************/
+
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int qid;
+
+  for (qid = 0; qid < priv->npairs; qid++)
+    {
+      virtio_net_txfreeq(dev, qid);
+    }
+}
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -355,6 +435,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int qid;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -371,9 +452,13 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (qid = 0; qid < priv->npairs; qid++)
+    {
+      virtqueue_enable_cb_lock(
+        priv->vdev->vrings_info[VIRTIO_NET_RXQ(qid)].vq,
+        &priv->lock[VIRTIO_NET_RXQ(qid)]);
+      virtio_net_rxfill(dev, qid);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -396,7 +481,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < priv->npairs * VIRTIO_NET_NUM; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -416,14 +501,15 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_sendq
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev, int qid,
+                            FAR netpkt_t *pkt)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_TXQ(qid)].vq;
 
   /* Check the send length */
 
@@ -435,58 +521,72 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TXQ(qid));
+  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TXQ(qid)]);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txfreeq(dev, qid);
 
   /* If we have no buffer left, enable TX done callback. */
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TXQ(qid)]);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_sendq(dev, 0, pkt);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recvq
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int qid)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(qid)].vq;
   FAR struct virtio_net_llhdr_s *hdr;
   irqstate_t flags;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, qid);
 
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
+  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RXQ(qid)]);
   hdr = virtqueue_get_buffer(vq, &len, NULL);
   if (hdr == NULL)
     {
       /* If we have no buffer left, enable RX callback. */
 
       virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RXQ(qid)], flags);
 
       vrtinfo("get NULL buffer\n");
       return NULL;
     }
   else
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RXQ(qid)], flags);
     }
 
+  priv->rxnum[qid]--;
+
   /* Set the received pkt length */
 
   netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
@@ -494,6 +594,15 @@ static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
   return hdr->pkt;
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recvq(dev, 0);
+}
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -536,8 +645,19 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
-  netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                 vq->vq_queue_index / VIRTIO_NET_NUM);
+    }
+  else
+#endif
+    {
+      netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+    }
 }
 
 /****************************************************************************
@@ -548,10 +668,86 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
-  netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev_lower_txdone_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                vq->vq_queue_index / VIRTIO_NET_NUM);
+    }
+  else
+#endif
+    {
+      netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
+    }
 }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/****************************************************************************
+ * Name: virtio_net_ctrldone
+ ****************************************************************************/
+
+static void virtio_net_ctrldone(FAR struct virtqueue *vq)
+{
+  FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
+  FAR sem_t *sem;
+
+  sem = virtqueue_get_buffer_lock(vq, NULL, NULL,
+                                  &priv->lock[VIRTIO_NET_CTRL_LOCK]);
+  if (sem != NULL)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_set_pairs
+ *
+ * Description:
+ *   Tell the device to use the priv->npairs queue pairs, it only uses the
+ *   first one until then.
+ *
+ ****************************************************************************/
+
+static int virtio_net_set_pairs(FAR struct virtio_net_priv_s *priv)
+{
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[priv->ctrlvq].vq;
+  FAR spinlock_t *lock = &priv->lock[VIRTIO_NET_CTRL_LOCK];
+  struct virtio_net_ctrl_mq_s ctrl;
+  struct virtqueue_buf vb[3];
+  sem_t sem;
+  int ret;
+
+  ctrl.class = VIRTIO_NET_CTRL_MQ;
+  ctrl.cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl.pairs = priv->npairs;
+  ctrl.ack   = ~VIRTIO_NET_OK;
+
+  vb[0].buf = &ctrl.class;
+  vb[0].len = sizeof(ctrl.class) + sizeof(ctrl.cmd);
+  vb[1].buf = &ctrl.pairs;
+  vb[1].len = sizeof(ctrl.pairs);
+  vb[2].buf = &ctrl.ack;
+  vb[2].len = sizeof(ctrl.ack);
+
+  nxsem_init(&sem, 0, 0);
+
+  virtqueue_enable_cb_lock(vq, lock);
+  virtqueue_add_buffer_lock(vq, vb, 2, 1, &sem, lock);
+  virtqueue_kick_lock(vq, lock);
+
+  ret = nxsem_wait_uninterruptible(&sem);
+  nxsem_destroy(&sem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return ctrl.ack == VIRTIO_NET_OK ? OK : -EIO;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -559,28 +755,102 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char *vqnames[VIRTIO_NET_MAX_VQS];
+  vq_callback callbacks[VIRTIO_NET_MAX_VQS];
+  FAR const char **names;
+  FAR vq_callback *cbs;
+  int nvqs;
   int ret;
+  int i;
+
+  for (i = 0; i < VIRTIO_NET_MAX_VQS; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
   priv->vdev = vdev;
+  priv->npairs = 1;
   vdev->priv = priv;
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+                                  (1UL << VIRTIO_NET_F_CTRL_VQ) |
+                                  (1UL << VIRTIO_NET_F_MQ) |
+#endif
                                   (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      uint16_t pairs;
+
+      /* The control virtqueue follows all the pairs of the device, use
+       * the first ones that fit and leave the others alone.
+       */
+
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &pairs);
+      if (pairs > 1)
+        {
+          priv->npairs = MIN(pairs, VIRTIO_NET_MAX_PAIRS);
+          priv->ctrlvq = pairs * VIRTIO_NET_NUM;
+        }
+      else
+        {
+          virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
+                                          (1UL << VIRTIO_F_ANY_LAYOUT),
+                                    NULL);
+        }
+    }
+#endif
+
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  names = vqnames;
+  cbs = callbacks;
+  nvqs = priv->npairs * VIRTIO_NET_NUM;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      /* The virtqueues are created by index, the unused pairs before the
+       * control virtqueue keep a NULL name and are skipped.
+       */
+
+      nvqs  = priv->ctrlvq + 1;
+      names = kmm_zalloc(nvqs * sizeof(*names));
+      cbs   = kmm_zalloc(nvqs * sizeof(*cbs));
+      if (names == NULL || cbs == NULL)
+        {
+          kmm_free(names);
+          kmm_free(cbs);
+          return -ENOMEM;
+        }
+
+      names[priv->ctrlvq] = "virtio_net_ctrl";
+      cbs[priv->ctrlvq]   = virtio_net_ctrldone;
+    }
+#endif
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      names[VIRTIO_NET_RXQ(i)] = "virtio_net_rx";
+      names[VIRTIO_NET_TXQ(i)] = "virtio_net_tx";
+      cbs[VIRTIO_NET_RXQ(i)]   = virtio_net_rxready;
+      cbs[VIRTIO_NET_TXQ(i)]   = virtio_net_txdone;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, names, cbs, NULL);
+  if (names != vqnames)
+    {
+      kmm_free(names);
+      kmm_free(cbs);
+    }
+
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -589,6 +859,20 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      ret = virtio_net_set_pairs(priv);
+      if (ret < 0)
+        {
+          /* The device keeps using the first pair only */
+
+          vrterr("set %d queue pairs failed, ret=%d\n", priv->npairs, ret);
+          priv->npairs = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
@@ -598,10 +882,12 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
 #endif
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+  for (i = 0; i < priv->npairs * VIRTIO_NET_NUM; i++)
+    {
+      priv->bufnum = MIN(vdev->vrings_info[i].info.num_descs /
+                         (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+    }
+
   return OK;
 }
 
@@ -661,6 +947,9 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   netdev->quota[NETPKT_RX] = priv->bufnum;
   netdev->quota[NETPKT_TX] = priv->bufnum;
   netdev->ops = &g_virtio_net_ops;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netdev->netdev.d_nqueues = priv->npairs;
+#endif
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
@@ -99,7 +99,7 @@ static void virtio_pci_vq_callback(FAR struct virtio_pci_device_s *vpdev)
   for (i = 0; i < vpdev->vdev.vrings_num; i++)
     {
       vq = vrings_info[i].vq;
-      if (vq->callback != NULL && virtqueue_nused(vq) > 0)
+      if (vq != NULL && vq->callback != NULL && virtqueue_nused(vq) > 0)
         {
           vq->callback(vq);
         }
@@ -401,10 +401,17 @@ int virtio_pci_create_virtqueues(FAR struct virtio_device *vdev,
       return -ENOMEM;
     }
 
-  /* Alloc and init the virtqueue */
+  /* Alloc and init the virtqueue, skipping the ones without a name that
+   * the driver does not use
+   */
 
   for (i = 0; i < nvqs; i++)
     {
+      if (names[i] == NULL)
+        {
+          continue;
+        }
+
       ret = virtio_pci_create_virtqueue(vpdev, i, names[i], callbacks[i]);
       if (ret < 0)
         {
@@ -66,6 +66,8 @@ extern const struct procfs_operations g_irq_operations;
 extern const struct procfs_operations g_meminfo_operations;
 extern const struct procfs_operations g_memdump_operations;
 extern const struct procfs_operations g_mempool_operations;
+extern const struct procfs_operations g_memprof_operations;
+extern const struct procfs_operations g_memreclaim_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
 extern const struct procfs_operations g_proc_operations;
@@ -73,6 +75,7 @@ extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
+extern const struct procfs_operations g_wqueue_operations;
 extern const struct procfs_operations g_pressure_operations;
 #if defined(CONFIG_FS_PROFILER) && defined(CONFIG_FS_PROCFS_PROFILER)
 extern const struct procfs_operations g_fsprofile_operations;
@@ -163,6 +166,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "mempool",      &g_mempool_operations,  PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MM_HEAP_PROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+  { "memprof",      &g_memprof_operations,  PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_MM_SHRINKER) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+  { "memreclaim",   &g_memreclaim_operations, PROCFS_FILE_TYPE },
+#endif
+
 #if defined(CONFIG_MODULE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   { "modules",      &g_module_operations,   PROCFS_FILE_TYPE   },
 #endif
@@ -211,6 +222,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_VERSION
   { "version",      &g_version_operations,  PROCFS_FILE_TYPE   },
 #endif
+
+#ifdef CONFIG_WQUEUE_STATS
+  { "wqueue",       &g_wqueue_operations,   PROCFS_FILE_TYPE   },
+#endif
 #if defined(CONFIG_FS_PROFILER) && defined(CONFIG_FS_PROCFS_PROFILER)
   { "profile",      &g_fsprofile_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -75,6 +75,19 @@ struct meminfo_file_s
   char line[MEMINFO_LINELEN];     /* Pre-allocated buffer for formatted lines */
 };
 
+#ifdef CONFIG_MM_SHRINKER
+/* The state of a read of /proc/memreclaim, passed to each shrinker */
+
+struct memreclaim_read_s
+{
+  FAR struct meminfo_file_s *procfile;
+  FAR char *buffer;
+  size_t buflen;
+  size_t totalsize;
+  off_t offset;
+};
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
 struct progmem_info_s
 {
@@ -108,6 +121,16 @@ static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
 #endif
 static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
                             size_t buflen);
+#ifdef CONFIG_MM_HEAP_PROFILE
+static ssize_t memprof_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+#endif
+#ifdef CONFIG_MM_SHRINKER
+static ssize_t memreclaim_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+static ssize_t memreclaim_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t buflen);
+#endif
 static int     meminfo_dup(FAR const struct file *oldp,
                            FAR struct file *newp);
 static int     meminfo_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -153,6 +176,40 @@ const struct procfs_operations g_memdump_operations =
 };
 #endif
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+const struct procfs_operations g_memprof_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  memprof_read,   /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
+#ifdef CONFIG_MM_SHRINKER
+const struct procfs_operations g_memreclaim_operations =
+{
+  meminfo_open,      /* open */
+  meminfo_close,     /* close */
+  memreclaim_read,   /* read */
+  memreclaim_write,  /* write */
+  NULL,              /* poll */
+  meminfo_dup,       /* dup */
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+  meminfo_stat       /* stat */
+};
+#endif
+
 static FAR struct procfs_meminfo_entry_s *g_procfs_meminfo = NULL;
 
 /****************************************************************************
@@ -655,6 +712,267 @@ dump:
 }
 #endif
 
+/****************************************************************************
+ * Name: memprof_read
+ *
+ * Description:
+ *   Show the allocation profile of every heap: a summary line, then the
+ *   allocations and free chunks per size class and the histogram of the
+ *   allocation latencies.  Empty classes are omitted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+static ssize_t memprof_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR const struct procfs_meminfo_entry_s *entry;
+  FAR struct meminfo_file_s *procfile;
+  FAR struct mm_heapprof_s *prof;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  off_t offset;
+  long frag;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* The profile is too large for the stack of the reader */
+
+  prof = fs_heap_malloc(sizeof(struct mm_heapprof_s));
+  if (prof == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL && buflen > 0;
+       entry = entry->next)
+    {
+      /* Only the heaps of the default manager are profiled */
+
+      if (entry->mallinfo != NULL)
+        {
+          continue;
+        }
+
+      mm_heapprof(entry->heap, prof);
+
+      /* The fragmentation index is the share of the free memory that is
+       * not part of the largest free chunk, in permille.
+       */
+
+      frag = prof->freesize > 0 ? (long)(1000 - (uint64_t)prof->largest *
+                                         1000 / prof->freesize) : 0;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%s: free %lu largest %lu minlargest %lu"
+                                   " frag %ld.%ld%% failed %lu"
+                                   " maxlatency %luns\n",
+                                   entry->name,
+                                   (unsigned long)prof->freesize,
+                                   (unsigned long)prof->largest,
+                                   (unsigned long)prof->minlargest,
+                                   frag / 10, frag % 10, prof->nfailed,
+                                   prof->maxlatency);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%12s%11s%11s\n",
+                                   "size", "nalloc", "nfree");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      for (i = 0; i < MM_PROF_NSIZES && buflen > 0; i++)
+        {
+          if (prof->nalloc[i] == 0 && prof->nfree[i] == 0)
+            {
+              continue;
+            }
+
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%11lu%s%11lu%11lu\n", 1ul << i,
+                                       i < MM_PROF_NSIZES - 1 ? " " : "+",
+                                       prof->nalloc[i], prof->nfree[i]);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+          buffer    += copysize;
+          buflen    -= copysize;
+        }
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%12s%11s\n", "latency<ns", "count");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      for (i = 0; i < MM_PROF_NLATENCY && buflen > 0; i++)
+        {
+          if (prof->latency[i] == 0)
+            {
+              continue;
+            }
+
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%11lu%s%11lu\n",
+                                       i < MM_PROF_NLATENCY - 1 ?
+                                       1ul << i : 1ul << (i - 1),
+                                       i < MM_PROF_NLATENCY - 1 ? " " : "+",
+                                       prof->latency[i]);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+          buffer    += copysize;
+          buflen    -= copysize;
+        }
+    }
+
+  fs_heap_free(prof);
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: memreclaim_handler
+ *
+ * Description:
+ *   Show one shrinker and the number of bytes it could release now.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_SHRINKER
+static void memreclaim_handler(FAR struct mm_shrinker_s *shrinker,
+                               FAR void *arg)
+{
+  FAR struct memreclaim_read_s *info = arg;
+  size_t linesize;
+  size_t copysize;
+
+  if (info->buflen == 0)
+    {
+      return;
+    }
+
+  linesize        = procfs_snprintf(info->procfile->line, MEMINFO_LINELEN,
+                                    "%-24s%11lu\n",
+                                    shrinker->name != NULL ?
+                                    shrinker->name : "-",
+                                    shrinker->count != NULL ?
+                                    (unsigned long)shrinker->count(shrinker)
+                                    : 0ul);
+  copysize        = procfs_memcpy(info->procfile->line, linesize,
+                                  info->buffer, info->buflen,
+                                  &info->offset);
+  info->totalsize += copysize;
+  info->buffer    += copysize;
+  info->buflen    -= copysize;
+}
+
+/****************************************************************************
+ * Name: memreclaim_read
+ *
+ * Description:
+ *   Show the background reclaim threshold and the registered shrinkers.
+ *
+ ****************************************************************************/
+
+static ssize_t memreclaim_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  struct memreclaim_read_s info;
+  size_t linesize;
+  size_t copysize;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  info.procfile  = filep->f_priv;
+  info.offset    = filep->f_pos;
+  DEBUGASSERT(info.procfile);
+
+  linesize       = procfs_snprintf(info.procfile->line, MEMINFO_LINELEN,
+                                   "threshold %lu\n%-24s%11s\n",
+                                   (unsigned long)mm_shrink_getthreshold(),
+                                   "shrinker", "reclaimable");
+  copysize       = procfs_memcpy(info.procfile->line, linesize, buffer,
+                                 buflen, &info.offset);
+  info.totalsize = copysize;
+  info.buffer    = buffer + copysize;
+  info.buflen    = buflen - copysize;
+
+  mm_shrink_foreach(memreclaim_handler, &info);
+
+  /* Update the file offset */
+
+  filep->f_pos += info.totalsize;
+  return info.totalsize;
+}
+
+/****************************************************************************
+ * Name: memreclaim_write
+ *
+ * Description:
+ *   "threshold <bytes>" sets the background reclaim threshold, "shrink
+ *   [<bytes>]" runs the shrinkers, by default until they release all they
+ *   can.
+ *
+ ****************************************************************************/
+
+static ssize_t memreclaim_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t buflen)
+{
+  FAR char *endptr;
+  size_t nbytes;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  if (strncmp(buffer, "threshold", 9) == 0)
+    {
+      nbytes = strtoul(buffer + 9, &endptr, 0);
+      if (endptr == buffer + 9)
+        {
+          return -EINVAL;
+        }
+
+      mm_shrink_setthreshold(nbytes);
+    }
+  else if (strncmp(buffer, "shrink", 6) == 0)
+    {
+      nbytes = strtoul(buffer + 6, &endptr, 0);
+      mm_shrink(endptr != buffer + 6 ? nbytes : SIZE_MAX);
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_dup
  *
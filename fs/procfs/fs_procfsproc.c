@@ -163,7 +163,7 @@ struct proc_envinfo_s
 
 static FAR const char * const g_policy[4] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -468,7 +468,12 @@ static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath)
  *                                   MQ full}
  *   Flags:      xxx                N,P,X
  *   Priority:   nnn                Decimal, 0-255
- *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC}
+ *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC,
+ *                                   SCHED_DEADLINE}
+ *   Deadline:   nnn/nnn/nnn        Runtime/deadline/period in ticks
+ *                                  (CONFIG_SCHED_DEADLINE only)
+ *   Misses:     nnn                Missed deadlines
+ *                                  (CONFIG_SCHED_DEADLINE only)
  *   Sigmask:    nnnnnnnn           Hexadecimal, 32-bit
  *
  ****************************************************************************/
@@ -639,6 +644,47 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
       return totalsize;
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Show the deadline reservation and the number of missed deadlines */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      FAR struct deadline_s *deadline = tcb->deadline;
+
+      linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                   "%-12s%lu/%lu/%lu\n", "Deadline:",
+                                   (unsigned long)deadline->runtime,
+                                   (unsigned long)deadline->deadline,
+                                   (unsigned long)deadline->period);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      if (totalsize >= buflen)
+        {
+          return totalsize;
+        }
+
+      linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                   "%-12s%" PRIu32 "\n", "Misses:",
+                                   deadline->nmisses);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      if (totalsize >= buflen)
+        {
+          return totalsize;
+        }
+    }
+#endif
+
   /* Show the signal mask. Note: sigset_t is uint32_t on NuttX. */
 #ifndef CONFIG_DISABLE_ALL_SIGNALS
   linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
@@ -77,11 +77,7 @@ struct hrtimer_s;
 typedef CODE uint64_t (*hrtimer_entry_t)(FAR const struct hrtimer_s *hrtimer,
                                          uint64_t expired);
 
-#ifdef CONFIG_HRTIMER_TREE
 typedef RB_ENTRY(hrtimer_s) hrtimer_node_t; /* RB-Tree node */
-#else
-typedef struct list_node    hrtimer_node_t; /* List node */
-#endif
 
 /* High-resolution timer object
  *
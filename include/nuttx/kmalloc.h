@@ -102,6 +102,7 @@ extern "C"
 #  define kmm_realloc(p,s)       realloc(p,s)
 #  define kmm_memalign(a,s)      memalign(a,s)
 #  define kmm_free(p)            free(p)
+#  define kmm_free_bulk(m,c)     umm_free_bulk(m,c)
 #  define kmm_mallinfo()         mallinfo()
 #  define kmm_heapmember(p)      umm_heapmember(p)
 #  define kmm_memdump(p)         umm_memdump(p)
@@ -80,7 +80,7 @@
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -220,6 +220,36 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_chain
+ *
+ * Description:
+ *   Allocate n I/O buffers at once, linked through io_flink, without
+ *   waiting for buffers to become free.  NULL is returned and nothing is
+ *   allocated if fewer than n buffers are available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_chain(unsigned int n, bool throttled);
+
+/****************************************************************************
+ * Name: iob_alloc_size/iob_tryalloc_size
+ *
+ * Description:
+ *   Allocate the smallest available I/O buffer that holds 'size' bytes,
+ *   or the largest available one if none does.  iob_alloc_size() waits
+ *   for a buffer of the IOB_BUFSIZE pool if no buffer is available.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled);
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled);
+#else
+#  define iob_alloc_size(s,t)    iob_alloc(t)
+#  define iob_tryalloc_size(s,t) iob_tryalloc(t)
+#endif
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
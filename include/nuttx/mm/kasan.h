@@ -29,6 +29,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <sys/types.h>
 
 #include <nuttx/arch.h>
 
@@ -49,7 +50,14 @@
 #  define kasan_debugpoint(t,a,s) 0
 #  define kasan_init_early()
 #  define kasan_bypass(state) ((void)state, state)
-#else
+#endif
+
+#ifndef CONFIG_MM_KASAN_SAMPLE
+#  define kasan_sample_free(owner, mem) false
+#  define kasan_sample_size(owner, mem) (-1)
+#endif
+
+#ifdef CONFIG_MM_KASAN
 
 #  define kasan_init_early() kasan_stop()
 
@@ -237,6 +245,60 @@ int kasan_debugpoint(int type, FAR void *addr, size_t size);
 
 bool kasan_bypass(bool state);
 
+#ifdef CONFIG_MM_KASAN_SAMPLE
+
+/****************************************************************************
+ * Name: kasan_sample_alloc
+ *
+ * Description:
+ *   Allocate one in CONFIG_MM_KASAN_SAMPLE_INTERVAL allocations from the
+ *   guarded pool of KASan instead of the heap.
+ *
+ * Input Parameters:
+ *   owner - The heap the allocation is made for
+ *   size  - The size of the allocation
+ *
+ * Returned Value:
+ *   The allocated memory, or NULL if the allocation is not sampled and has
+ *   to be made from the heap.
+ *
+ ****************************************************************************/
+
+FAR void *kasan_sample_alloc(FAR void *owner, size_t size);
+
+/****************************************************************************
+ * Name: kasan_sample_free
+ *
+ * Description:
+ *   Free memory allocated by kasan_sample_alloc().
+ *
+ * Input Parameters:
+ *   owner - The heap the memory is freed to
+ *   mem   - The memory to free
+ *
+ * Returned Value:
+ *   true if the memory was freed, false if it is not part of the pool.
+ *
+ ****************************************************************************/
+
+bool kasan_sample_free(FAR void *owner, FAR void *mem);
+
+/****************************************************************************
+ * Name: kasan_sample_size
+ *
+ * Input Parameters:
+ *   owner - The heap the memory was allocated for
+ *   mem   - The memory to query
+ *
+ * Returned Value:
+ *   The usable size of memory allocated by kasan_sample_alloc(), or -1 if
+ *   the memory was not allocated that way for the owner.
+ *
+ ****************************************************************************/
+
+ssize_t kasan_sample_size(FAR void *owner, FAR const void *mem);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
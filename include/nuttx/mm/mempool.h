@@ -87,6 +87,51 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+/* A magazine holds free blocks of one pool for one CPU */
+
+struct mempool_magazine_s
+{
+  sq_entry_t entry;   /* Link in the depot */
+  size_t     nrounds; /* The number of blocks held */
+  FAR void  *rounds[CONFIG_MM_HEAP_MEMPOOL_MAGAZINE_SIZE];
+};
+
+/* The magazines loaded by one CPU, only accessed by that CPU with the
+ * local interrupts disabled.
+ */
+
+struct mempool_cpucache_s
+{
+  FAR struct mempool_magazine_s *loaded;   /* Magazine in use */
+  FAR struct mempool_magazine_s *previous; /* Full or empty spare */
+  unsigned long                  nhit;     /* Served from the magazines */
+  unsigned long                  nmiss;    /* Passed to the pool */
+};
+
+/* The magazine cache in front of one pool */
+
+struct mempool_cache_s
+{
+  struct mempool_cpucache_s cpu[CONFIG_SMP_NCPUS];
+  spinlock_t                lock;  /* The protect lock to the depot */
+  sq_queue_t                full;  /* The full magazines of the depot */
+  sq_queue_t                empty; /* The empty magazines of the depot */
+};
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+/* The free blocks cached by one CPU, only accessed by that CPU with the
+ * local interrupts disabled.
+ */
+
+struct mempool_pcpu_s
+{
+  sq_queue_t queue; /* The free blocks owned by the CPU */
+  size_t     nfree; /* The number of blocks in queue */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -110,6 +155,12 @@ struct mempool_s
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  struct mempool_pcpu_s pcpu[CONFIG_SMP_NCPUS]; /* The per-CPU free lists */
+#endif
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  FAR struct mempool_cache_s *cache; /* The per-CPU magazine cache or NULL */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
@@ -139,6 +190,10 @@ struct mempoolinfo_s
   unsigned long aordblks; /* This is the number of used blocks */
   unsigned long sizeblks; /* This is the size of a mempool blocks */
   unsigned long nwaiter;  /* This is the number of waiter for mempool */
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  unsigned long nhit;     /* This is the number of magazine cache hits */
+  unsigned long nmiss;    /* This is the number of magazine cache misses */
+#endif
 };
 
 /****************************************************************************
@@ -255,6 +310,35 @@ void mempool_memdump(FAR struct mempool_s *pool,
 
 int mempool_deinit(FAR struct mempool_s *pool);
 
+/****************************************************************************
+ * Name: mempool_drain
+ *
+ * Description:
+ *   Return the free blocks cached by the calling CPU to the pool.
+ *
+ * Input Parameters:
+ *   pool    - Address of the memory pool to be used.
+ ****************************************************************************/
+
+void mempool_drain(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_shrink
+ *
+ * Description:
+ *   Release the expansions of the pool whose blocks are all free.  The
+ *   blocks cached by a CPU are not free for the pool, mempool_drain() must
+ *   be called on every CPU first to release them too.
+ *
+ * Input Parameters:
+ *   pool    - Address of the memory pool to be used.
+ *
+ * Returned Value:
+ *   The number of bytes released.
+ ****************************************************************************/
+
+size_t mempool_shrink(FAR struct mempool_s *pool);
+
 /****************************************************************************
  * Name: mempool_info_task
  *
@@ -487,6 +571,23 @@ void mempool_multiple_memdump(FAR struct mempool_multiple_s *mpool,
 
 void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool);
 
+/****************************************************************************
+ * Name: mempool_multiple_shrink
+ *
+ * Description:
+ *   Return the blocks cached by all CPUs to the pools and release the
+ *   expansions whose blocks are all free.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ * Returned Value:
+ *   The number of bytes released.
+ *
+ ****************************************************************************/
+
+size_t mempool_multiple_shrink(FAR struct mempool_multiple_s *mpool);
+
 /****************************************************************************
  * Name: mempool_multiple_foreach
  * Description:
@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/list.h>
 #include <nuttx/userspace.h>
 
 #include <sys/types.h>
@@ -178,12 +179,57 @@
 #  define MM_INCSEQNO(p)
 #endif
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+/* Chunk size class n holds the sizes in [2^n, 2^(n+1)) and latency class n
+ * the latencies in [2^(n-1), 2^n) nanoseconds.  The last classes also hold
+ * everything larger.
+ */
+
+#  define MM_PROF_NSIZES    28
+#  define MM_PROF_NLATENCY  24
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
 struct mm_heap_s; /* Forward reference */
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+struct mm_heapprof_s
+{
+  unsigned long nalloc[MM_PROF_NSIZES];     /* Allocations per size class */
+  unsigned long nfree[MM_PROF_NSIZES];      /* Free chunks per size class */
+  unsigned long latency[MM_PROF_NLATENCY];  /* Allocation latency classes */
+  unsigned long nfailed;                    /* Failed allocations */
+  unsigned long maxlatency;                 /* Worst latency in ns */
+  size_t        freesize;                   /* Total size of free chunks */
+  size_t        largest;                    /* Largest free chunk */
+  size_t        minlargest;                 /* Low watermark of largest */
+};
+#endif
+
+#ifdef CONFIG_MM_SHRINKER
+/* A cache that can release memory when the kernel heap runs low.  count()
+ * returns the number of bytes the cache could release now, scan()
+ * releases up to 'nbytes' of them and returns the number of bytes
+ * released.  Both are called from a task with the heap unlocked, but
+ * possibly from inside of a failing allocation, so they must not wait for
+ * a lock that may be held while memory is allocated.
+ */
+
+struct mm_shrinker_s
+{
+  struct list_node node;    /* Link in the list of shrinkers */
+  FAR const char  *name;    /* Name shown in /proc/memreclaim */
+  CODE size_t    (*count)(FAR struct mm_shrinker_s *shrinker);
+  CODE size_t    (*scan)(FAR struct mm_shrinker_s *shrinker, size_t nbytes);
+};
+
+typedef CODE void (*mm_shrinker_handler_t)(FAR struct mm_shrinker_s *,
+                                           FAR void *);
+#endif
+
 struct mm_heap_config_s
 {
   /* If heap == NULL, means use the heap memory ([start, start + size])
@@ -338,13 +384,20 @@ size_t kmm_malloc_size(FAR void *mem);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_free_bulk(FAR struct mm_heap_s *heap, FAR void *const *mem,
+                  size_t count);
 
 /* Functions contained in kmm_free.c ****************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
 void kmm_free(FAR void *mem);
+void kmm_free_bulk(FAR void *const *mem, size_t count);
 #endif
 
+/* Functions contained in umm_free.c ****************************************/
+
+void umm_free_bulk(FAR void *const *mem, size_t count);
+
 /* Functions contained in mm_realloc.c **************************************/
 
 FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
@@ -446,6 +499,24 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 size_t mm_heapfree(FAR struct mm_heap_s *heap);
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap);
 
+/* Functions contained in mm_profile.c **************************************/
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+void mm_heapprof(FAR struct mm_heap_s *heap,
+                 FAR struct mm_heapprof_s *prof);
+#endif
+
+/* Functions contained in mm_shrink.c **************************************/
+
+#ifdef CONFIG_MM_SHRINKER
+void mm_register_shrinker(FAR struct mm_shrinker_s *shrinker);
+void mm_unregister_shrinker(FAR struct mm_shrinker_s *shrinker);
+size_t mm_shrink(size_t nbytes);
+void mm_shrink_setthreshold(size_t threshold);
+size_t mm_shrink_getthreshold(void);
+void mm_shrink_foreach(mm_shrinker_handler_t handler, FAR void *arg);
+#endif
+
 /* Functions contained in kmm_mallinfo.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
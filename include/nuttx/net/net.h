@@ -333,6 +333,19 @@ ssize_t net_ioctl_arglen(uint8_t domain, int cmd);
  *                       momentarily to wait for an IOB to become
  *                       available.
  *
+ * The network lock only serializes configuration changes.  The data path
+ * uses finer grained locks, taken in this order:
+ *
+ *   netdev_lock()     - Per-device lock, held while a packet of the device
+ *                       is received or polled for transmission.
+ *   tcp/udp_conn_list_lock()
+ *                     - Protects the lists and hashtables of connections
+ *                       of one protocol.  It is only held to look up a
+ *                       connection, not while delivering data to it, or
+ *                       to bind a port to a connection.
+ *   conn_lock()       - Per-connection lock, protecting the state and the
+ *                       buffers of one connection.
+ *
  ****************************************************************************/
 
 /****************************************************************************
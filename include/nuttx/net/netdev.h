@@ -84,6 +84,23 @@
 
 #define NETDEV_TX_CSUM  (1 << 1) /* Netdev support hardware tx checksum */
 #define NETDEV_RX_CSUM  (1 << 2) /* Netdev support hardware rx checksum */
+#define NETDEV_TX_GSO   (1 << 3) /* Netdev accept TCP packets above MTU */
+#define NETDEV_TX_TSO   (1 << 4) /* Netdev support hardware segmentation */
+#define NETDEV_RX_LRO   (1 << 5) /* Netdev support hardware rx coalescing */
+#define NETDEV_RX_RSS   (1 << 6) /* Netdev steers rx flows to the queues */
+
+/* The largest IP packet the stack may build for a device.  A device with
+ * NETDEV_TX_GSO takes TCP packets of several segments, they are split to
+ * the MTU by the netdev upper half or by the hardware (NETDEV_TX_TSO).
+ */
+
+#ifdef CONFIG_NETDEV_GSO
+#  define NETDEV_GSO_MAXLEN(d) \
+     (((d)->d_features & NETDEV_TX_GSO) != 0 ? CONFIG_NETDEV_GSO_MAXSIZE : \
+      NETDEV_PKTSIZE(d) - NET_LL_HDRLEN(d))
+#else
+#  define NETDEV_GSO_MAXLEN(d) (NETDEV_PKTSIZE(d) - NET_LL_HDRLEN(d))
+#endif
 
 /* Determine the largest possible address */
 
@@ -278,6 +295,22 @@ struct netdev_statistics_s
   struct work_s logwork;   /* For periodic log work */
 #endif
 };
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* The counts of the events of one TX/RX queue pair of a multi-queue
+ * device.
+ */
+
+struct netdev_queue_statistics_s
+{
+  uint32_t rx_packets;     /* Number of packets received on the queue */
+  uint32_t rx_steered;     /* Number of packets steered to another queue */
+  uint64_t rx_bytes;       /* Number of bytes received on the queue */
+  uint32_t tx_packets;     /* Number of Tx packets queued */
+  uint32_t tx_done;        /* Number of Tx done notifications */
+  uint64_t tx_bytes;       /* Number of bytes send */
+};
+#endif
 #endif
 
 #if defined(CONFIG_NET_6LOWPAN) || defined(CONFIG_NET_BLUETOOTH) || \
@@ -521,6 +554,16 @@ struct net_driver_s
    */
 
   struct netdev_statistics_s d_statistics;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* The counts of each TX/RX queue pair of a multi-queue device */
+
+  struct netdev_queue_statistics_s d_qstatistics[CONFIG_NETDEV_MAX_QUEUES];
+#endif
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  uint8_t d_nqueues;            /* Number of TX/RX queue pairs */
 #endif
 
 #if defined(CONFIG_NET_TIMESTAMP)
@@ -1345,4 +1388,30 @@ int netdev_checksum_offset(FAR struct net_driver_s *dev);
 
 uint16_t netdev_upperlayer_header_checksum(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_rss_hash
+ *
+ * Description:
+ *   Calculate the RSS hash of a TCP or UDP flow with the Toeplitz function
+ *   and the key used by RSS hardware, over the addresses and ports as they
+ *   are in the received packets.
+ *
+ * Input Parameters:
+ *   domain   - The layer 3 protocol, PF_INET/PF_INET6
+ *   src_addr - The source address of the packets, in network order
+ *   src_port - The source port of the packets, in network order
+ *   dst_addr - The destination address of the packets, in network order
+ *   dst_port - The destination port of the packets, in network order
+ *
+ * Returned Value:
+ *   The hash value of the flow
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+uint32_t netdev_rss_hash(uint8_t domain,
+                         FAR const void *src_addr, uint16_t src_port,
+                         FAR const void *dst_addr, uint16_t dst_port);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
@@ -89,10 +89,11 @@ enum netpkt_type_e
 
 enum netdev_rx_e
 {
-  NETDEV_RX_WORK,      /* Use work queue thread */
-  NETDEV_RX_DIRECT,    /* Directly based on the current thread */
-  NETDEV_RX_THREAD,    /* Upper half dedicated thread */
-  NETDEV_RX_THREAD_RSS /* RSS mode, upper half thread */
+  NETDEV_RX_WORK,       /* Use work queue thread */
+  NETDEV_RX_DIRECT,     /* Directly based on the current thread */
+  NETDEV_RX_THREAD,     /* Upper half dedicated thread */
+  NETDEV_RX_THREAD_RSS, /* RSS mode, upper half thread */
+  NETDEV_RX_WORK_RSS    /* RSS mode, per-CPU work queue */
 };
 
 /* This structure is the generic form of state structure used by lower half
@@ -119,7 +120,9 @@ struct netdev_lowerhalf_s
   FAR const struct wireless_ops_s *iw_ops;
 #endif
 
-  /* Max # of buffer held by driver */
+  /* Max # of buffer held by driver, over all the queues of a multi-queue
+   * device.
+   */
 
   FAR atomic_t *quota_ptr; /* Shared quota, ignore `quota` if ptr is set */
   atomic_t quota[NETPKT_TYPENUM];
@@ -132,6 +135,26 @@ struct netdev_lowerhalf_s
    *
    * Fields that lowerhalf should never touch (used by upper half):
    *   d_ifup, d_ifdown, d_txavail, d_addmac, d_rmmac, d_ioctl, d_private
+   *
+   * Offloads are enabled by setting d_features before registering:
+   *   NETDEV_TX_CSUM/NETDEV_RX_CSUM - The hardware computes/verifies the
+   *     checksums, the upper half merges received TCP segments (GRO) only
+   *     with NETDEV_RX_CSUM.
+   *   NETDEV_TX_GSO - TCP builds packets above the MTU, split by the upper
+   *     half (GSO).  Set by the upper half if the TX quota holds the
+   *     segments of the largest one.
+   *   NETDEV_TX_TSO - transmit() gets TCP packets above the MTU to be split
+   *     into segments of netpkt_gso_size() bytes, instead of the segments
+   *     split by the upper half (GSO).
+   *   NETDEV_RX_LRO - receive() may return TCP segments merged by the
+   *     hardware, the upper half does not merge them again.
+   *
+   * Multi-queue devices set d_nqueues to their number of TX/RX queue pairs
+   * before registering, and implement transmitq()/receiveq() instead of
+   * transmit()/receive().  Their rxtype is NETDEV_RX_WORK, each queue is
+   * then polled by its own work, or NETDEV_RX_DIRECT.  The upper half
+   * steers the received flows to the queues by their RSS hash, unless the
+   * hardware does (NETDEV_RX_RSS).
    */
 
   struct net_driver_s netdev;
@@ -180,6 +203,17 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmitq/receiveq - Same as transmit/receive, on the queue `qid` of a
+   *   multi-queue device.
+   */
+
+  CODE int (*transmitq)(FAR struct netdev_lowerhalf_s *dev, int qid,
+                        FAR netpkt_t *pkt);
+  CODE FAR netpkt_t *(*receiveq)(FAR struct netdev_lowerhalf_s *dev,
+                                 int qid);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -316,6 +350,40 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about RX packets ready to read on a queue
+ *   of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The queue with packets ready
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev, int qid);
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about TX packets sent on a queue of a
+ *   multi-queue device.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The queue with packets sent
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev, int qid);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -555,6 +623,29 @@ bool netpkt_is_fragmented(FAR netpkt_t *pkt);
 int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                   FAR struct iovec *iov, int iovcnt);
 
+/****************************************************************************
+ * Name: netpkt_gso_size
+ *
+ * Description:
+ *   Get the payload size of the segments a TCP packet above the MTU is to
+ *   be split into.  Only drivers which set NETDEV_TX_TSO in d_features
+ *   before registering are given such packets, all others get segments
+ *   split by the upper half.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ * Returned Value:
+ *   The payload size of the segments, or 0 if the packet fits the MTU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+unsigned int netpkt_gso_size(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt);
+#endif
+
 /****************************************************************************
  * Name: netpkt_tryadd_queue
  *
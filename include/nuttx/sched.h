@@ -98,6 +98,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 5)                      /* Bit 5: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 6)                      /* Bit 6: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 7)                      /* Bit 7: In a system call */
@@ -137,6 +138,12 @@
 #define SPORADIC_FLAG_REPLENISH    (1 << 2)                      /* Bit 2: Replenishment cycle */
                                                                  /* Bits 3-7: Available */
 
+/* Deadline scheduler flags */
+
+#define DEADLINE_FLAG_THROTTLED    (1 << 0)                      /* Bit 0: Budget exhausted */
+#define DEADLINE_FLAG_CHECKED      (1 << 1)                      /* Bit 1: Deadline was checked */
+                                                                 /* Bits 2-7: Available */
+
 /* Most internal nxsched_* interfaces are not available in the user space in
  * PROTECTED and KERNEL builds.  In that context, the application semaphore
  * interfaces must be used.  The differences between the two sets of
@@ -348,6 +355,34 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure that
+ * holds the reservation and the state of the current job of a thread using
+ * the deadline scheduling policy.  All times are in system clock ticks.
+ */
+
+struct deadline_s
+{
+  uint8_t   hi_priority;            /* Priority while within budget          */
+  uint8_t   flags;                  /* See DEADLINE_FLAG_* definitions       */
+  clock_t   runtime;                /* Execution budget per period           */
+  clock_t   deadline;               /* Relative deadline of each job         */
+  clock_t   period;                 /* Job release period                    */
+  clock_t   release;                /* Release time of the current job       */
+  clock_t   abs_deadline;           /* Absolute deadline of the current job  */
+  clock_t   budget;                 /* Budget left to the current job        */
+  clock_t   eventtime;              /* Time thread was last resumed          */
+  uint32_t  util;                   /* Reserved bandwidth (parts per million)*/
+  uint32_t  nmisses;                /* Number of missed deadlines            */
+  struct wdog_s timer;              /* Release and deadline timer            */
+  struct wdog_s budget_timer;       /* Budget enforcement timer              */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -632,6 +667,9 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters  */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
 
@@ -280,7 +280,7 @@ int nxsem_trywait_slow(FAR sem_t *sem);
 int nxsem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime);
 
 /****************************************************************************
- * Name: nxsem_clockwait
+ * Name: nxsem_clockwait / nxsem_clockwait_slow
  *
  * Description:
  *   This function will lock the semaphore referenced by sem as in the
@@ -326,9 +326,11 @@ int nxsem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime);
 
 int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
                     FAR const struct timespec *abstime);
+int nxsem_clockwait_slow(FAR sem_t *sem, clockid_t clockid,
+                         FAR const struct timespec *abstime);
 
 /****************************************************************************
- * Name: nxsem_tickwait
+ * Name: nxsem_tickwait / nxsem_tickwait_slow
  *
  * Description:
  *   This function is a lighter weight version of sem_timedwait().  It is
@@ -351,6 +353,7 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
  ****************************************************************************/
 
 int nxsem_tickwait(FAR sem_t *sem, uint32_t delay);
+int nxsem_tickwait_slow(FAR sem_t *sem, uint32_t delay);
 
 /****************************************************************************
  * Name: nxsem_post / nxsem_post_slow
@@ -344,7 +344,9 @@ int wd_start_next(FAR struct wdog_s *wdog, clock_t delay,
  *
  * Description:
  *   This function cancels a currently running watchdog timer. Watchdog
- *   timers may be cancelled from the interrupt level.
+ *   timers may be cancelled from the interrupt level.  If the function of
+ *   the watchdog is running on another CPU, wd_cancel() returns once it
+ *   has returned.
  *
  * Input Parameters:
  *   wdog - ID of the watchdog to cancel.
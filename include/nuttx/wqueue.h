@@ -101,6 +101,7 @@
 
 #  undef CONFIG_SCHED_HPWORK
 #  undef CONFIG_SCHED_LPWORK
+#  undef CONFIG_SCHED_PCPUWORK
 #  undef CONFIG_SCHED_WORKQUEUE
 
   /* User-space worker threads are not built in a kernel build when we are
@@ -177,6 +178,20 @@
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+/* Per-CPU kernel work queue configuration **********************************/
+
+#ifdef CONFIG_SCHED_PCPUWORK
+
+#  ifndef CONFIG_SCHED_PCPUWORKPRIORITY
+#    define CONFIG_SCHED_PCPUWORKPRIORITY 224
+#  endif
+
+#  ifndef CONFIG_SCHED_PCPUWORKSTACKSIZE
+#    define CONFIG_SCHED_PCPUWORKSTACKSIZE CONFIG_IDLETHREAD_STACKSIZE
+#  endif
+
+#endif /* CONFIG_SCHED_PCPUWORK */
+
 /* User space work queue configuration **************************************/
 
 #ifdef CONFIG_LIBC_USRWORK
@@ -253,6 +268,9 @@ struct work_s
   clock_t          qtime;  /* Time work queued */
   worker_t         worker; /* Work callback */
   FAR void        *arg;    /* Callback argument */
+#ifdef CONFIG_WQUEUE_LOCKFREE
+  FAR struct kwork_wqueue_s *volatile inbox; /* Inbox holding the work */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
@@ -442,6 +460,37 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
                        FAR struct work_s *work, worker_t worker,
                        FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_on/work_cancel_on/work_cancel_sync_on
+ *
+ * Description:
+ *   Queue or cancel work on the per-CPU work queue of the CPU 'cpu'.  The
+ *   work is performed by the worker thread bound to that CPU.  Work queued
+ *   with work_queue_on() must be cancelled on the same CPU.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU that shall perform the work
+ *   work   - The work structure to queue or cancel
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure.  -EINVAL is returned if
+ *   the CPU is not valid or its work queue is not started yet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PCPUWORK
+int work_queue_on(int cpu, FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay);
+int work_cancel_on(int cpu, FAR struct work_s *work);
+int work_cancel_sync_on(int cpu, FAR struct work_s *work);
+#endif
+
 /****************************************************************************
  * Name: work_queue_pri
  *
@@ -220,6 +220,11 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_REUSEPORT    19 /* Allow sockets to bind to the same address and
+                            * port and share the incoming datagrams (get/set)
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
 #define SO_TIMESTAMPNS  20 /* Generates a timestamp in ns for each incoming packet
                             * arg: integer value
                             */
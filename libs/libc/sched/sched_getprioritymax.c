@@ -54,7 +54,8 @@
 
 int sched_get_priority_max(int policy)
 {
-  if (policy < SCHED_OTHER || policy > SCHED_SPORADIC)
+  if ((policy < SCHED_OTHER || policy > SCHED_SPORADIC) &&
+      policy != SCHED_DEADLINE)
     {
       set_errno(EINVAL);
       return ERROR;
@@ -28,10 +28,13 @@
 
 #include <time.h>
 #include <errno.h>
+#include <assert.h>
 
 #include <nuttx/cancelpt.h>
 #include <nuttx/semaphore.h>
 
+#include "semaphore.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -104,3 +107,42 @@ int sem_clockwait(FAR sem_t *sem, clockid_t clockid,
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxsem_clockwait
+ *
+ * Description:
+ *   This function will lock the semaphore referenced by sem as in the
+ *   sem_wait() function. However, if the semaphore cannot be locked without
+ *   waiting for another process or thread to unlock the semaphore by
+ *   performing a sem_post() function, this wait will be terminated when the
+ *   specified timeout expires.
+ *
+ *   An uncontended semaphore is taken with the atomic fast path, only
+ *   a wait that may block calls into the kernel.
+ *
+ * Input Parameters:
+ *   sem     - Semaphore object
+ *   clockid - The timing source to use in the conversion
+ *   abstime - The absolute time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   This is an internal OS interface and should not be used by applications.
+ *   It follows the NuttX internal error return policy:  Zero (OK) is
+ *   returned on success.  A negated errno value is returned on failure.
+ *   See nxsem_clockwait_slow() for the possible errors.
+ *
+ ****************************************************************************/
+
+int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
+                    FAR const struct timespec *abstime)
+{
+  DEBUGASSERT(sem != NULL && abstime != NULL);
+
+  if (nxsem_trywait_fast(sem) == OK)
+    {
+      return OK;
+    }
+
+  return nxsem_clockwait_slow(sem, clockid, abstime);
+}
@@ -36,6 +36,8 @@
 #include <nuttx/atomic.h>
 #include <nuttx/irq.h>
 
+#include "semaphore.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -107,8 +109,7 @@ int sem_trywait(FAR sem_t *sem)
 
 int nxsem_trywait(FAR sem_t *sem)
 {
-  bool fastpath = true;
-  bool mutex;
+  int ret;
 
   DEBUGASSERT(sem != NULL);
 
@@ -119,55 +120,10 @@ int nxsem_trywait(FAR sem_t *sem)
               up_interrupt_context());
 #endif
 
-  mutex = NXSEM_IS_MUTEX(sem);
-
-  /* Disable fast path if priority protection is enabled on the semaphore */
-
-#ifdef CONFIG_PRIORITY_PROTECT
-  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_PROTECT)
-    {
-      fastpath = false;
-    }
-#endif
-
-  /* Disable fast path on a counting semaphore with priority inheritance */
-
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  if (!mutex && (sem->flags & SEM_PRIO_MASK) != SEM_PRIO_NONE)
-    {
-      fastpath = false;
-    }
-#endif
-
-  while (fastpath)
+  ret = nxsem_trywait_fast(sem);
+  if (ret != -ENOTSUP)
     {
-      FAR atomic_t *val = mutex ? NXSEM_MHOLDER(sem) : NXSEM_COUNT(sem);
-      int32_t old = atomic_read(val);
-      int32_t new;
-
-      if (mutex)
-        {
-          if (old != NXSEM_NO_MHOLDER)
-            {
-              return -EAGAIN;
-            }
-
-          new = _SCHED_GETTID();
-        }
-      else
-        {
-          if (old < 1)
-            {
-              return -EAGAIN;
-            }
-
-          new = old - 1;
-        }
-
-      if (atomic_try_cmpxchg_acquire(val, &old, new))
-        {
-          return OK;
-        }
+      return ret;
     }
 
   return nxsem_trywait_slow(sem);
@@ -37,6 +37,8 @@
 #include <nuttx/atomic.h>
 #include <nuttx/irq.h>
 
+#include "semaphore.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -135,9 +137,6 @@ errout_with_cancelpt:
 
 int nxsem_wait(FAR sem_t *sem)
 {
-  bool fastpath = true;
-  bool mutex;
-
   DEBUGASSERT(sem != NULL);
 
   /* This API should not be called from the idleloop or interrupt */
@@ -147,55 +146,9 @@ int nxsem_wait(FAR sem_t *sem)
               up_interrupt_context());
 #endif
 
-  mutex = NXSEM_IS_MUTEX(sem);
-
-  /* Disable fast path if priority protection is enabled on the semaphore */
-
-#ifdef CONFIG_PRIORITY_PROTECT
-  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_PROTECT)
-    {
-      fastpath = false;
-    }
-#endif
-
-  /* Disable fast path on a counting semaphore with priority inheritance */
-
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  if (!mutex && (sem->flags & SEM_PRIO_MASK) != SEM_PRIO_NONE)
-    {
-      fastpath = false;
-    }
-#endif
-
-  while (fastpath)
+  if (nxsem_trywait_fast(sem) == OK)
     {
-      FAR atomic_t *val = mutex ? NXSEM_MHOLDER(sem) : NXSEM_COUNT(sem);
-      int32_t old = atomic_read(val);
-      int32_t new;
-
-      if (mutex)
-        {
-          if (old != NXSEM_NO_MHOLDER)
-            {
-              break;
-            }
-
-          new = _SCHED_GETTID();
-        }
-      else
-        {
-          if (old < 1)
-            {
-              break;
-            }
-
-          new = old - 1;
-        }
-
-      if (atomic_try_cmpxchg_acquire(val, &old, new))
-        {
-          return OK;
-        }
+      return OK;
     }
 
   return nxsem_wait_slow(sem);
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * libs/libc/semaphore/semaphore.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBC_SEMAPHORE_SEMAPHORE_H
+#define __LIBS_LIBC_SEMAPHORE_SEMAPHORE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdbool.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/atomic.h>
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_trywait_fast
+ *
+ * Description:
+ *   Try to take the semaphore with a compare-and-swap on its count (or on
+ *   the holder of a mutex) without entering the kernel.  The slow paths
+ *   are only needed when the semaphore is not available or when it needs
+ *   holder bookkeeping.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor.
+ *
+ * Returned Value:
+ *   OK if the semaphore was taken, -EAGAIN if it is not available and
+ *   -ENOTSUP if the semaphore can only be taken in the slow path.
+ *
+ ****************************************************************************/
+
+static inline_function int nxsem_trywait_fast(FAR sem_t *sem)
+{
+  bool mutex = NXSEM_IS_MUTEX(sem);
+  FAR atomic_t *val;
+  int32_t old;
+  int32_t new;
+
+  /* Disable fast path if priority protection is enabled on the semaphore */
+
+#ifdef CONFIG_PRIORITY_PROTECT
+  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_PROTECT)
+    {
+      return -ENOTSUP;
+    }
+#endif
+
+  /* Disable fast path on a counting semaphore with priority inheritance */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (!mutex && (sem->flags & SEM_PRIO_MASK) != SEM_PRIO_NONE)
+    {
+      return -ENOTSUP;
+    }
+#endif
+
+  val = mutex ? NXSEM_MHOLDER(sem) : NXSEM_COUNT(sem);
+  old = atomic_read(val);
+
+  do
+    {
+      if (mutex)
+        {
+          if (old != NXSEM_NO_MHOLDER)
+            {
+              return -EAGAIN;
+            }
+
+          new = _SCHED_GETTID();
+        }
+      else
+        {
+          if (old < 1)
+            {
+              return -EAGAIN;
+            }
+
+          new = old - 1;
+        }
+    }
+  while (!atomic_try_cmpxchg_acquire(val, &old, new));
+
+  return OK;
+}
+
+#endif /* __LIBS_LIBC_SEMAPHORE_SEMAPHORE_H */
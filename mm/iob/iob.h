@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+
 #include <nuttx/debug.h>
 
 #include <nuttx/mm/iob.h>
@@ -137,6 +139,77 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return a list of I/O buffers, linked through io_flink, to the global
+ *   pool, handing them to the waiting allocations first.  This function is
+ *   intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob);
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+/****************************************************************************
+ * Name: iob_pcpu_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of this CPU, refilling the cache
+ *   from the global pool if it is empty.  NULL is returned if neither has
+ *   a buffer for the allocation.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_pcpu_alloc(bool throttled);
+
+/****************************************************************************
+ * Name: iob_pcpu_free
+ *
+ * Description:
+ *   Put an I/O buffer into the cache of this CPU.  false is returned if
+ *   the buffer must go to the global pool instead because an allocation
+ *   is waiting for it.
+ *
+ ****************************************************************************/
+
+bool iob_pcpu_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_pcpu_flush
+ *
+ * Description:
+ *   Return the I/O buffers cached by all CPUs to the global pool.
+ *
+ ****************************************************************************/
+
+void iob_pcpu_flush(void);
+
+/****************************************************************************
+ * Name: iob_pcpu_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers cached by all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_pcpu_navail(void);
+#endif
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the I/O buffers of the size classes.  This function is intended
+ *   only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_class_initialize(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
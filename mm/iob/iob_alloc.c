@@ -173,6 +173,16 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
    * we are waiting for I/O buffers to become free.
    */
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* Try the cache of this CPU first */
+
+  iob = iob_pcpu_alloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
   flags = spin_lock_irqsave(&g_iob_lock);
 
   /* Try to get an I/O buffer */
@@ -193,6 +203,14 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+      /* Now that we are registered as waiter, return the buffers cached by
+       * the CPUs to the pool.  They are committed to us if we need them.
+       */
+
+      iob_pcpu_flush();
+#endif
+
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -305,9 +323,31 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
    * to protect the free list:  We disable interrupts very briefly.
    */
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  iob = iob_pcpu_alloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
   flags = spin_lock_irqsave(&g_iob_lock);
   iob = iob_tryalloc_internal(throttled);
   spin_unlock_irqrestore(&g_iob_lock, flags);
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* The other CPUs may still cache free buffers */
+
+  if (iob == NULL && iob_pcpu_navail() > 0)
+    {
+      iob_pcpu_flush();
+
+      flags = spin_lock_irqsave(&g_iob_lock);
+      iob = iob_tryalloc_internal(throttled);
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+    }
+#endif
+
   return iob;
 }
 
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * mm/iob/iob_alloc_chain.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_alloc_chain
+ *
+ * Description:
+ *   Allocate n I/O buffers at once, without waiting for buffers to become
+ *   free.  The buffers are taken from the pool with a single acquisition of
+ *   the pool lock, which makes this cheaper than n calls to iob_tryalloc()
+ *   for drivers that refill their receive rings.
+ *
+ * Input Parameters:
+ *   n         - The number of I/O buffers to allocate
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ * Returned Value:
+ *   The n I/O buffers linked through io_flink, or NULL if fewer than n
+ *   buffers are available.  In that case nothing is allocated.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_chain(unsigned int n, bool throttled)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  unsigned int i;
+  int navail;
+
+  if (n == 0)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* Collect the buffers cached by the CPUs if the pool falls short */
+
+  if (g_iob_count < (int)n && iob_pcpu_navail() > 0)
+    {
+      iob_pcpu_flush();
+    }
+#endif
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  navail = g_iob_count;
+#if CONFIG_IOB_THROTTLE > 0
+  if (throttled)
+    {
+      navail -= CONFIG_IOB_THROTTLE;
+    }
+#else
+  UNUSED(throttled);
+#endif
+
+  if (navail < (int)n)
+    {
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+      return NULL;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      iob = g_iob_freelist;
+      DEBUGASSERT(iob != NULL);
+
+      g_iob_freelist = iob->io_flink;
+      iob->io_flink  = head;
+      head           = iob;
+    }
+
+  g_iob_count -= n;
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  /* Put the I/O buffers in a known state */
+
+  for (iob = head; iob != NULL; iob = iob->io_flink)
+    {
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return head;
+}
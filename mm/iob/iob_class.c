@@ -0,0 +1,335 @@
+/****************************************************************************
+ * mm/iob/iob_class.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_IOB_SMALL_NBUFFERS
+#  define CONFIG_IOB_SMALL_NBUFFERS 0
+#endif
+
+#ifndef CONFIG_IOB_LARGE_NBUFFERS
+#  define CONFIG_IOB_LARGE_NBUFFERS 0
+#endif
+
+#ifndef CONFIG_IOB_JUMBO_NBUFFERS
+#  define CONFIG_IOB_JUMBO_NBUFFERS 0
+#endif
+
+/* Every I/O buffer of a class is laid out like the ones returned by
+ * iob_alloc_dynamic(): the iob_s is followed by its aligned payload.
+ */
+
+#define IOB_CLASS_STRIDE(s)      (ALIGN_UP(sizeof(struct iob_s), \
+                                           IOB_ALIGNMENT) + \
+                                  ALIGN_UP(s, IOB_ALIGNMENT))
+#define IOB_CLASS_BUFFER(n, s)   (IOB_CLASS_STRIDE(s) * (n) + \
+                                  IOB_ALIGNMENT - 1)
+
+#ifdef IOB_SECTION
+#  define iob_class_data         locate_data(IOB_SECTION)
+#else
+#  define iob_class_data
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct iob_class_s
+{
+  FAR struct iob_s *freelist; /* Free I/O buffers of the class */
+  FAR uint8_t      *buffer;   /* Memory holding the I/O buffers */
+  size_t            size;     /* Size of that memory */
+  uint16_t          bufsize;  /* Payload size, zero ends the table */
+  int               nbuffers; /* Number of I/O buffers of the class */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+static uint8_t g_iob_small[IOB_CLASS_BUFFER(CONFIG_IOB_SMALL_NBUFFERS,
+                                            CONFIG_IOB_SMALL_BUFSIZE)]
+  iob_class_data;
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static uint8_t g_iob_large[IOB_CLASS_BUFFER(CONFIG_IOB_LARGE_NBUFFERS,
+                                            CONFIG_IOB_LARGE_BUFSIZE)]
+  iob_class_data;
+#endif
+
+#if CONFIG_IOB_JUMBO_NBUFFERS > 0
+static uint8_t g_iob_jumbo[IOB_CLASS_BUFFER(CONFIG_IOB_JUMBO_NBUFFERS,
+                                            CONFIG_IOB_JUMBO_BUFSIZE)]
+  iob_class_data;
+#endif
+
+/* The free lists of the classes are protected by g_iob_lock */
+
+static struct iob_class_s g_iob_class[] =
+{
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  {
+    NULL, g_iob_small, sizeof(g_iob_small),
+    CONFIG_IOB_SMALL_BUFSIZE, CONFIG_IOB_SMALL_NBUFFERS
+  },
+#endif
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  {
+    NULL, g_iob_large, sizeof(g_iob_large),
+    CONFIG_IOB_LARGE_BUFSIZE, CONFIG_IOB_LARGE_NBUFFERS
+  },
+#endif
+#if CONFIG_IOB_JUMBO_NBUFFERS > 0
+  {
+    NULL, g_iob_jumbo, sizeof(g_iob_jumbo),
+    CONFIG_IOB_JUMBO_BUFSIZE, CONFIG_IOB_JUMBO_NBUFFERS
+  },
+#endif
+  {
+    NULL, NULL, 0, 0, 0
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_class_free
+ *
+ * Description:
+ *   The io_free callback of the I/O buffers of a class, return the buffer
+ *   to the free list of its class.
+ *
+ ****************************************************************************/
+
+static void iob_class_free(FAR void *data)
+{
+  FAR struct iob_s *iob = data;
+  FAR struct iob_class_s *iobc;
+  irqstate_t flags;
+
+  for (iobc = g_iob_class; iobc->bufsize != 0; iobc++)
+    {
+      if ((FAR uint8_t *)iob >= iobc->buffer &&
+          (FAR uint8_t *)iob < iobc->buffer + iobc->size)
+        {
+          flags = spin_lock_irqsave(&g_iob_lock);
+          iob->io_flink   = iobc->freelist;
+          iobc->freelist = iob;
+          spin_unlock_irqrestore(&g_iob_lock, flags);
+          return;
+        }
+    }
+
+  DEBUGPANIC();
+}
+
+/****************************************************************************
+ * Name: iob_class_better
+ *
+ * Description:
+ *   Return true if a buffer of 'bufsize' bytes fits a request of 'size'
+ *   bytes better than the best buffer found so far of 'best' bytes, zero
+ *   if there is none yet.
+ *
+ ****************************************************************************/
+
+static bool iob_class_better(unsigned int bufsize, unsigned int best,
+                             unsigned int size)
+{
+  if (best == 0)
+    {
+      return true;
+    }
+  else if (bufsize >= size)
+    {
+      /* Prefer the smallest buffer that holds the request */
+
+      return best < size || bufsize < best;
+    }
+  else
+    {
+      /* Otherwise the largest one, so that the chain gets shorter */
+
+      return best < size && bufsize > best;
+    }
+}
+
+/****************************************************************************
+ * Name: iob_class_alloc
+ *
+ * Description:
+ *   Take the best fitting I/O buffer of a class for a request of 'size'
+ *   bytes.  NULL is returned if a buffer of the IOB_BUFSIZE pool fits
+ *   better or if no class has a free buffer.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_class_alloc(unsigned int size, bool throttled)
+{
+  FAR struct iob_class_s *iobc;
+  FAR struct iob_class_s *best = NULL;
+  FAR struct iob_s *iob = NULL;
+  unsigned int bestsize = 0;
+  irqstate_t flags;
+
+  /* The IOB_BUFSIZE pool is one of the candidates */
+
+  if (iob_navail(throttled) > 0)
+    {
+      bestsize = CONFIG_IOB_BUFSIZE;
+    }
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  for (iobc = g_iob_class; iobc->bufsize != 0; iobc++)
+    {
+      if (iobc->freelist != NULL &&
+          iob_class_better(iobc->bufsize, bestsize, size))
+        {
+          best     = iobc;
+          bestsize = iobc->bufsize;
+        }
+    }
+
+  if (best != NULL)
+    {
+      iob            = best->freelist;
+      best->freelist = iob->io_flink;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the I/O buffers of the size classes.  This function is intended
+ *   only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_class_initialize(void)
+{
+  FAR struct iob_class_s *iobc;
+  FAR struct iob_s *iob;
+  uintptr_t buf;
+  int i;
+
+  for (iobc = g_iob_class; iobc->bufsize != 0; iobc++)
+    {
+      buf = ALIGN_UP((uintptr_t)iobc->buffer, IOB_ALIGNMENT);
+
+      for (i = 0; i < iobc->nbuffers; i++)
+        {
+          iob = (FAR struct iob_s *)
+                (buf + i * IOB_CLASS_STRIDE(iobc->bufsize));
+
+          /* io_data is where iob_free() expects the payload of a buffer
+           * with its own io_free callback.
+           */
+
+          iob->io_bufsize = iobc->bufsize;
+          iob->io_free    = iob_class_free;
+          iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
+                                                    IOB_ALIGNMENT);
+          iob->io_flink   = iobc->freelist;
+          iobc->freelist = iob;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate the smallest available I/O buffer that holds 'size' bytes,
+ *   or the largest available one if none does.  Wait for a buffer of the
+ *   IOB_BUFSIZE pool if no buffer is available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled)
+{
+  FAR struct iob_s *iob = iob_class_alloc(size, throttled);
+
+  return iob != NULL ? iob : iob_alloc(throttled);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Allocate the smallest available I/O buffer that holds 'size' bytes,
+ *   or the largest available one if none does, without waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled)
+{
+  FAR struct iob_s *iob = iob_class_alloc(size, throttled);
+
+  return iob != NULL ? iob : iob_tryalloc(throttled);
+}
+
+#endif /* CONFIG_IOB_SIZE_CLASSES */
@@ -54,13 +54,6 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len)
   FAR struct iob_s *next;
   unsigned int ncopy;
 
-  /* We can't make more contiguous space that the size of one I/O buffer.
-   * If you get this assertion and really need that much contiguous data,
-   * then you will need to increase CONFIG_IOB_BUFSIZE.
-   */
-
-  DEBUGASSERT(len <= IOB_BUFSIZE(iob));
-
   /* Check if there is already sufficient, contiguous space at the beginning
    * of the packet
    */
@@ -72,6 +65,18 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len)
       return 0;
     }
 
+  /* We can't make more contiguous space that the size of the head I/O
+   * buffer.  With I/O buffer size classes the head may be a small buffer,
+   * so this is not necessarily a programming error.
+   */
+
+  else if (len > IOB_BUFSIZE(iob))
+    {
+      ioberr("ERROR: bufsize=%u < requested len=%u\n",
+             IOB_BUFSIZE(iob), len);
+      return -ENOSPC;
+    }
+
   /* Can we get the required amount of contiguous data by just packing the
    * head I/0 buffer?
    */
@@ -121,7 +126,7 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len)
 
       /* This should always succeed because we know that:
        *
-       *   pktlen >= CONFIG_IOB_BUFSIZE >= len
+       *   pktlen >= len and IOB_BUFSIZE(iob) >= len
        */
 
       return 0;
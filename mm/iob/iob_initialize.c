@@ -174,4 +174,8 @@ void iob_initialize(void)
       g_iob_freeqlist = iobq;
     }
 #endif
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+  iob_class_initialize();
+#endif
 }
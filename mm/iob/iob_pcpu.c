@@ -0,0 +1,325 @@
+/****************************************************************************
+ * mm/iob/iob_pcpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A cache is refilled with IOB_PCPU_BATCH buffers when it runs empty and
+ * the buffers above IOB_PCPU_BATCH are returned to the pool once it holds
+ * more than IOB_PCPU_LIMIT.
+ */
+
+#define IOB_PCPU_BATCH CONFIG_IOB_PERCPU_BATCH
+#define IOB_PCPU_LIMIT (2 * CONFIG_IOB_PERCPU_BATCH)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cached buffers count as allocated in g_iob_count.  The cache of a
+ * CPU is only used by that CPU with interrupts disabled, the lock is only
+ * contended when another CPU flushes it.
+ */
+
+struct iob_pcpu_s
+{
+  spinlock_t        lock;  /* Protects the cache */
+  FAR struct iob_s *head;  /* Cached I/O buffers */
+  int16_t           count; /* Number of cached I/O buffers */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_pcpu_s g_iob_pcpu[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_pcpu_waiters
+ *
+ * Description:
+ *   Return true if an allocation is waiting for a buffer of the pool.
+ *
+ ****************************************************************************/
+
+static inline bool iob_pcpu_waiters(void)
+{
+#if CONFIG_IOB_THROTTLE > 0
+  return g_iob_count < 0 || g_throttle_wait > 0;
+#else
+  return g_iob_count < 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_pcpu_refill
+ *
+ * Description:
+ *   Move up to IOB_PCPU_BATCH buffers from the pool into the cache with a
+ *   single acquisition of the pool lock.  The cache must be locked.
+ *
+ ****************************************************************************/
+
+static void iob_pcpu_refill(FAR struct iob_pcpu_s *pcpu, bool throttled)
+{
+  FAR struct iob_s *iob;
+  int16_t navail;
+  int i;
+
+  spin_lock(&g_iob_lock);
+
+  navail = g_iob_count;
+#if CONFIG_IOB_THROTTLE > 0
+  if (throttled)
+    {
+      navail -= CONFIG_IOB_THROTTLE;
+    }
+#endif
+
+  for (i = 0; i < IOB_PCPU_BATCH && i < navail; i++)
+    {
+      iob = g_iob_freelist;
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      g_iob_freelist = iob->io_flink;
+      g_iob_count--;
+
+      iob->io_flink  = pcpu->head;
+      pcpu->head     = iob;
+      pcpu->count++;
+    }
+
+  spin_unlock(&g_iob_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_pcpu_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of this CPU, refilling the cache
+ *   from the global pool if it is empty.  NULL is returned if neither has
+ *   a buffer for the allocation.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_pcpu_alloc(bool throttled)
+{
+  FAR struct iob_pcpu_s *pcpu;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* The cached buffers are not part of the pool, so a throttled allocation
+   * may only take one while the pool holds its throttle reserve.
+   */
+
+  if (throttled && g_iob_count < CONFIG_IOB_THROTTLE)
+    {
+      return NULL;
+    }
+#endif
+
+  flags = up_irq_save();
+  pcpu  = &g_iob_pcpu[this_cpu()];
+  spin_lock(&pcpu->lock);
+
+  if (pcpu->head == NULL)
+    {
+      iob_pcpu_refill(pcpu, throttled);
+    }
+
+  iob = pcpu->head;
+  if (iob != NULL)
+    {
+      pcpu->head = iob->io_flink;
+      pcpu->count--;
+    }
+
+  spin_unlock(&pcpu->lock);
+  up_irq_restore(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_pcpu_free
+ *
+ * Description:
+ *   Put an I/O buffer into the cache of this CPU.  false is returned if
+ *   the buffer must go to the global pool instead because an allocation
+ *   is waiting for it.
+ *
+ ****************************************************************************/
+
+bool iob_pcpu_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_pcpu_s *pcpu;
+  FAR struct iob_s *spill = NULL;
+  FAR struct iob_s *last;
+  irqstate_t flags;
+  int i;
+
+  if (iob_pcpu_waiters())
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  pcpu  = &g_iob_pcpu[this_cpu()];
+  spin_lock(&pcpu->lock);
+
+  iob->io_flink = pcpu->head;
+  pcpu->head    = iob;
+  pcpu->count++;
+
+  /* An allocation may have started to wait after the check above.  It
+   * flushes the caches after registering as waiter, so either that flush
+   * finds the buffer or this check sees the waiter.
+   */
+
+  if (iob_pcpu_waiters())
+    {
+      spill       = pcpu->head;
+      pcpu->head  = NULL;
+      pcpu->count = 0;
+    }
+  else if (pcpu->count > IOB_PCPU_LIMIT)
+    {
+      /* Keep the most recently freed buffers, which are still hot in the
+       * data cache, and return the older ones.
+       */
+
+      for (last = pcpu->head, i = 1; i < IOB_PCPU_BATCH; i++)
+        {
+          last = last->io_flink;
+        }
+
+      spill          = last->io_flink;
+      last->io_flink = NULL;
+      pcpu->count    = IOB_PCPU_BATCH;
+    }
+
+  spin_unlock(&pcpu->lock);
+  up_irq_restore(flags);
+
+  if (spill != NULL)
+    {
+      iob_free_pool(spill);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_pcpu_flush
+ *
+ * Description:
+ *   Return the I/O buffers cached by all CPUs to the global pool.
+ *
+ ****************************************************************************/
+
+void iob_pcpu_flush(void)
+{
+  FAR struct iob_pcpu_s *pcpu;
+  FAR struct iob_s *head;
+  irqstate_t flags;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      pcpu  = &g_iob_pcpu[cpu];
+      flags = spin_lock_irqsave(&pcpu->lock);
+
+      head        = pcpu->head;
+      pcpu->head  = NULL;
+      pcpu->count = 0;
+
+      spin_unlock_irqrestore(&pcpu->lock, flags);
+
+      if (head != NULL)
+        {
+          iob_free_pool(head);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: iob_pcpu_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers cached by all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_pcpu_navail(void)
+{
+  int navail = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      navail += g_iob_pcpu[cpu].count;
+    }
+
+  return navail;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE */
@@ -57,6 +57,13 @@ void iob_getstats(FAR struct iob_stats_s *stats)
   stats->ntotal = CONFIG_IOB_NBUFFERS;
 
   stats->nfree = g_iob_count;
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  if (stats->nfree >= 0)
+    {
+      stats->nfree += iob_pcpu_navail();
+    }
+#endif
+
   if (stats->nfree < 0)
     {
       stats->nwait = -stats->nfree;
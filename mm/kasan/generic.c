@@ -67,76 +67,99 @@ struct kasan_region_s
  ****************************************************************************/
 
 static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
+static FAR struct kasan_region_s *g_region_last;
 static size_t g_region_count;
 static spinlock_t g_lock;
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KASAN_SAMPLE
+static void kasan_sample_initialize(void);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline_function FAR uintptr_t *
-kasan_mem_to_shadow(FAR const void *ptr, size_t size,
-                    FAR unsigned int *bit)
+/****************************************************************************
+ * Name: kasan_find_region
+ *
+ * Description:
+ *   Return the region holding the address.  Consecutive accesses mostly hit
+ *   the same region, so the region found last is tried before the others.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct kasan_region_s *
+kasan_find_region(uintptr_t addr)
 {
-  uintptr_t addr = (uintptr_t)ptr;
+  FAR struct kasan_region_s *region = g_region_last;
   size_t i;
 
+  if (predict_true(region != NULL &&
+                   addr >= region->begin && addr < region->end))
+    {
+      return region;
+    }
+
   for (i = 0; i < g_region_count; i++)
     {
-      if (addr >= g_region[i]->begin && addr < g_region[i]->end)
+      region = g_region[i];
+      if (addr >= region->begin && addr < region->end)
         {
-          DEBUGASSERT(addr + size <= g_region[i]->end);
-          addr -= g_region[i]->begin;
-          addr /= KASAN_SHADOW_SCALE;
-          *bit  = addr % KASAN_BITS_PER_WORD;
-          return &g_region[i]->shadow[addr / KASAN_BITS_PER_WORD];
+          g_region_last = region;
+          return region;
         }
     }
 
   return NULL;
 }
 
-static inline_function bool
-kasan_is_poisoned(FAR const void *addr, size_t size)
+static inline_function FAR uintptr_t *
+kasan_mem_to_shadow(FAR const void *ptr, size_t size,
+                    FAR unsigned int *bit)
 {
-  FAR uintptr_t *p;
-  unsigned int bit;
-  unsigned int nbit;
-  uintptr_t mask;
+  FAR struct kasan_region_s *region;
+  uintptr_t addr = (uintptr_t)ptr;
 
-  p = kasan_mem_to_shadow(addr, size, &bit);
-  if (p == NULL)
+  region = kasan_find_region(addr);
+  if (region == NULL)
     {
-      return kasan_global_is_poisoned(addr, size);
+      return NULL;
     }
 
-  if (size <= KASAN_SHADOW_SCALE)
-    {
-      return ((*p >> bit) & 1);
-    }
+  DEBUGASSERT(addr + size <= region->end);
+  addr -= region->begin;
+  addr /= KASAN_SHADOW_SCALE;
+  *bit  = addr % KASAN_BITS_PER_WORD;
+  return &region->shadow[addr / KASAN_BITS_PER_WORD];
+}
 
-  nbit = KASAN_BITS_PER_WORD - bit % KASAN_BITS_PER_WORD;
-  mask = KASAN_FIRST_WORD_MASK(bit);
-  size = ALIGN_UP(size, KASAN_SHADOW_SCALE);
-  size /= KASAN_SHADOW_SCALE;
+static bool kasan_is_poisoned_range(FAR const uintptr_t *p,
+                                    unsigned int bit, size_t nbits)
+{
+  unsigned int nbit = KASAN_BITS_PER_WORD - bit;
+  uintptr_t mask = KASAN_FIRST_WORD_MASK(bit);
 
-  while (size >= nbit)
+  while (nbits >= nbit)
     {
       if ((*p++ & mask) != 0)
         {
           return true;
         }
 
-      bit  += nbit;
-      size -= nbit;
+      bit   += nbit;
+      nbits -= nbit;
 
       nbit = KASAN_BITS_PER_WORD;
       mask = UINTPTR_MAX;
     }
 
-  if (size)
+  if (nbits)
     {
-      mask &= KASAN_LAST_WORD_MASK(bit + size);
+      mask &= KASAN_LAST_WORD_MASK(bit + nbits);
       if ((*p & mask) != 0)
         {
           return true;
@@ -146,6 +169,50 @@ kasan_is_poisoned(FAR const void *addr, size_t size)
   return false;
 }
 
+/****************************************************************************
+ * Name: kasan_is_poisoned
+ *
+ * Description:
+ *   Return true if any byte of the access is poisoned.  The instrumented
+ *   accesses have a constant size of at most 16 bytes, so once this is
+ *   inlined into their hooks the shadow bits of the access are tested with
+ *   a single mask, only accesses crossing a shadow word take the loop.
+ *
+ ****************************************************************************/
+
+static inline_function bool
+kasan_is_poisoned(FAR const void *ptr, size_t size)
+{
+  FAR struct kasan_region_s *region;
+  uintptr_t addr = (uintptr_t)ptr;
+  uintptr_t first;
+  uintptr_t last;
+  uintptr_t mask;
+
+  region = kasan_find_region(addr);
+  if (region == NULL)
+    {
+      return kasan_global_is_poisoned(ptr, size);
+    }
+
+  DEBUGASSERT(addr + size <= region->end);
+  first = (addr - region->begin) / KASAN_SHADOW_SCALE;
+  last  = (addr + size - 1 - region->begin) / KASAN_SHADOW_SCALE;
+
+  if (predict_true(first / KASAN_BITS_PER_WORD ==
+                   last / KASAN_BITS_PER_WORD))
+    {
+      mask = UINTPTR_MAX >> (KASAN_BITS_PER_WORD - 1 - (last - first));
+      mask <<= first % KASAN_BITS_PER_WORD;
+      return (region->shadow[first / KASAN_BITS_PER_WORD] & mask) != 0;
+    }
+
+  return kasan_is_poisoned_range(&region->shadow[first /
+                                                 KASAN_BITS_PER_WORD],
+                                 first % KASAN_BITS_PER_WORD,
+                                 last - first + 1);
+}
+
 static void kasan_set_poison(FAR const void *addr, size_t size,
                              bool poisoned)
 {
@@ -200,6 +267,31 @@ static void kasan_set_poison(FAR const void *addr, size_t size,
   spin_unlock_irqrestore(&g_lock, flags);
 }
 
+/****************************************************************************
+ * Name: kasan_add_region
+ *
+ * Description:
+ *   Start checking the accesses to the memory of the region, which is
+ *   poisoned.
+ *
+ ****************************************************************************/
+
+static void kasan_add_region(FAR struct kasan_region_s *region)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_lock);
+
+  DEBUGASSERT(g_region_count < CONFIG_MM_KASAN_REGIONS);
+  g_region[g_region_count++] = region;
+
+  spin_unlock_irqrestore(&g_lock, flags);
+
+  kasan_start();
+  kasan_poison((FAR const void *)region->begin,
+               region->end - region->begin);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -237,25 +329,20 @@ bool kasan_bypass(bool state)
 
 void kasan_register(FAR void *addr, FAR size_t *size)
 {
-  FAR struct kasan_region_s *region;
-  irqstate_t flags;
+#ifdef CONFIG_MM_KASAN_SAMPLE
+  /* Only the sampled allocations are checked, not the whole heap */
 
-  region = (FAR struct kasan_region_s *)
+  kasan_sample_initialize();
+#else
+  FAR struct kasan_region_s *region = (FAR struct kasan_region_s *)
     ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
 
   region->begin = (uintptr_t)addr;
   region->end   = region->begin + *size;
 
-  flags = spin_lock_irqsave(&g_lock);
-
-  DEBUGASSERT(g_region_count < CONFIG_MM_KASAN_REGIONS);
-  g_region[g_region_count++] = region;
-
-  spin_unlock_irqrestore(&g_lock, flags);
-
-  kasan_start();
-  kasan_poison(addr, *size);
+  kasan_add_region(region);
   *size -= KASAN_REGION_SIZE(*size);
+#endif
 }
 
 void kasan_unregister(FAR void *addr)
@@ -270,6 +357,7 @@ void kasan_unregister(FAR void *addr)
         {
           size_t size = g_region[i]->end - g_region[i]->begin;
           g_region_count--;
+          g_region_last = NULL;
           memmove(&g_region[i], &g_region[i + 1],
                   (g_region_count - i) * sizeof(g_region[0]));
           spin_unlock_irqrestore(&g_lock, flags);
@@ -39,6 +39,9 @@
 
 #ifdef CONFIG_MM_KASAN_GENERIC
 #  include "generic.c"
+#  ifdef CONFIG_MM_KASAN_SAMPLE
+#    include "sample.c"
+#  endif
 #elif defined(CONFIG_MM_KASAN_SW_TAGS)
 #  include "sw_tags.c"
 #elif defined(CONFIG_MM_KASAN_HW_TAGS)
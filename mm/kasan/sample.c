@@ -0,0 +1,290 @@
+/****************************************************************************
+ * mm/kasan/sample.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/nuttx.h>
+#include <nuttx/mm/kasan.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/compiler.h>
+#include <nuttx/debug.h>
+#include <nuttx/spinlock.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The pool is made of slots, each one preceded by a guard which is always
+ * poisoned.  A sampled allocation is placed at the end of its slot so that
+ * an overflow runs into the guard of the next slot.  The guard is as large
+ * as the memory covered by one shadow word.
+ */
+
+#define KASAN_SAMPLE_GUARD    (KASAN_SHADOW_SCALE * KASAN_BITS_PER_WORD)
+#define KASAN_SAMPLE_SLOTSIZE \
+  ALIGN_UP(CONFIG_MM_KASAN_SAMPLE_SLOTSIZE, KASAN_SAMPLE_GUARD)
+#define KASAN_SAMPLE_STRIDE   (KASAN_SAMPLE_GUARD + KASAN_SAMPLE_SLOTSIZE)
+#define KASAN_SAMPLE_POOLSIZE \
+  (CONFIG_MM_KASAN_SAMPLE_SLOTS * KASAN_SAMPLE_STRIDE + KASAN_SAMPLE_GUARD)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kasan_sample_slot_s
+{
+  FAR void *owner; /* The heap the memory was allocated for */
+  FAR void *mem;   /* The allocated memory, NULL if the slot is free */
+};
+
+struct kasan_sample_region_s
+{
+  struct kasan_region_s region;
+  uintptr_t shadow[KASAN_SHADOW_SIZE(KASAN_SAMPLE_POOLSIZE) /
+                   sizeof(uintptr_t)];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_sample_pool[KASAN_SAMPLE_POOLSIZE]
+               aligned_data(KASAN_SAMPLE_GUARD);
+static struct kasan_sample_region_s g_sample_region;
+static struct kasan_sample_slot_s
+       g_sample_slot[CONFIG_MM_KASAN_SAMPLE_SLOTS];
+static size_t g_sample_next;
+static int g_sample_countdown;
+static spinlock_t g_sample_lock;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kasan_sample_initialize
+ *
+ * Description:
+ *   Register the pool as the only region checked by KASan.  Called for
+ *   every heap registered, only the first call does anything.
+ *
+ ****************************************************************************/
+
+static void kasan_sample_initialize(void)
+{
+  if (g_sample_region.region.end != 0)
+    {
+      return;
+    }
+
+  g_sample_region.region.begin = (uintptr_t)g_sample_pool;
+  g_sample_region.region.end   = (uintptr_t)g_sample_pool +
+                                 sizeof(g_sample_pool);
+  g_sample_countdown           = CONFIG_MM_KASAN_SAMPLE_INTERVAL;
+
+  kasan_add_region(&g_sample_region.region);
+}
+
+/****************************************************************************
+ * Name: kasan_sample_slot
+ *
+ * Description:
+ *   Return the slot the address lies in, NULL if it is outside the pool.
+ *   An address in the last guard belongs to the last slot.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct kasan_sample_slot_s *
+kasan_sample_slot(FAR const void *mem)
+{
+  uintptr_t offset = (uintptr_t)mem - (uintptr_t)g_sample_pool;
+
+  if (offset >= sizeof(g_sample_pool))
+    {
+      return NULL;
+    }
+
+  offset /= KASAN_SAMPLE_STRIDE;
+  if (offset >= CONFIG_MM_KASAN_SAMPLE_SLOTS)
+    {
+      offset = CONFIG_MM_KASAN_SAMPLE_SLOTS - 1;
+    }
+
+  return &g_sample_slot[offset];
+}
+
+/****************************************************************************
+ * Name: kasan_sample_end
+ *
+ * Description:
+ *   Return the end of the memory of the slot.
+ *
+ ****************************************************************************/
+
+static inline_function uintptr_t
+kasan_sample_end(FAR struct kasan_sample_slot_s *slot)
+{
+  return (uintptr_t)g_sample_pool + (slot - g_sample_slot + 1) *
+         KASAN_SAMPLE_STRIDE;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kasan_sample_alloc
+ *
+ * Description:
+ *   Allocate one in CONFIG_MM_KASAN_SAMPLE_INTERVAL allocations from the
+ *   pool, the other allocations and those larger than a slot are left to
+ *   the heap.
+ *
+ ****************************************************************************/
+
+FAR void *kasan_sample_alloc(FAR void *owner, size_t size)
+{
+  FAR struct kasan_sample_slot_s *slot = NULL;
+  irqstate_t flags;
+  uintptr_t mem;
+  uintptr_t end;
+  size_t i;
+
+  /* The countdown is not protected, a lost update only moves the next
+   * sample by one allocation.
+   */
+
+  if (size > KASAN_SAMPLE_SLOTSIZE - MM_ALIGN ||
+      predict_true(--g_sample_countdown > 0))
+    {
+      return NULL;
+    }
+
+  /* Take the free slot used least recently, to keep the freed memory
+   * poisoned as long as possible.
+   */
+
+  flags = spin_lock_irqsave(&g_sample_lock);
+  for (i = 0; i < CONFIG_MM_KASAN_SAMPLE_SLOTS; i++)
+    {
+      FAR struct kasan_sample_slot_s *next =
+        &g_sample_slot[(g_sample_next + i) % CONFIG_MM_KASAN_SAMPLE_SLOTS];
+
+      if (next->mem == NULL)
+        {
+          slot = next;
+          break;
+        }
+    }
+
+  if (slot == NULL)
+    {
+      spin_unlock_irqrestore(&g_sample_lock, flags);
+      return NULL;
+    }
+
+  /* Place the memory at the end of the slot, an access past the shadow
+   * granule of its last byte runs into the guard of the next slot.
+   */
+
+  end = kasan_sample_end(slot);
+  mem = ALIGN_DOWN(end - ALIGN_UP(size ? size : 1, KASAN_SHADOW_SCALE),
+                   MM_ALIGN);
+
+  slot->owner   = owner;
+  slot->mem     = (FAR void *)mem;
+  g_sample_next = slot - g_sample_slot + 1;
+
+  g_sample_countdown = CONFIG_MM_KASAN_SAMPLE_INTERVAL;
+  spin_unlock_irqrestore(&g_sample_lock, flags);
+
+  return kasan_unpoison((FAR void *)mem, end - mem);
+}
+
+/****************************************************************************
+ * Name: kasan_sample_free
+ *
+ * Description:
+ *   Free the memory if it was allocated from the pool and poison it until
+ *   the slot is reused.  false is returned if the memory is not part of
+ *   the pool.
+ *
+ ****************************************************************************/
+
+bool kasan_sample_free(FAR void *owner, FAR void *mem)
+{
+  FAR struct kasan_sample_slot_s *slot;
+  irqstate_t flags;
+
+  slot = kasan_sample_slot(mem);
+  if (predict_true(slot == NULL))
+    {
+      return false;
+    }
+
+  flags = spin_lock_irqsave(&g_sample_lock);
+  if (slot->mem != mem || slot->owner != owner)
+    {
+      spin_unlock_irqrestore(&g_sample_lock, flags);
+      _alert("kasan detected an invalid or double free, address at %p\n",
+             mem);
+      PANIC();
+    }
+
+  /* Poison the memory before the slot may be taken again */
+
+  kasan_poison(mem, kasan_sample_end(slot) - (uintptr_t)mem);
+  slot->owner = NULL;
+  slot->mem   = NULL;
+  spin_unlock_irqrestore(&g_sample_lock, flags);
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: kasan_sample_size
+ *
+ * Description:
+ *   Return the usable size of memory allocated from the pool for the owner,
+ *   or -1 if the memory is not such an allocation.
+ *
+ ****************************************************************************/
+
+ssize_t kasan_sample_size(FAR void *owner, FAR const void *mem)
+{
+  FAR struct kasan_sample_slot_s *slot;
+
+  slot = kasan_sample_slot(mem);
+  if (predict_true(slot == NULL) ||
+      slot->mem != mem || slot->owner != owner)
+    {
+      return -1;
+    }
+
+  return kasan_sample_end(slot) - (uintptr_t)mem;
+}
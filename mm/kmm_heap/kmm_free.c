@@ -58,4 +58,25 @@ void kmm_free(FAR void *mem)
   mm_free(g_kmmheap, mem);
 }
 
+/****************************************************************************
+ * Name: kmm_free_bulk
+ *
+ * Description:
+ *   Returns a set of chunks of kernel memory to the heap, taking the heap
+ *   lock only once.  NULL entries are ignored.
+ *
+ * Input Parameters:
+ *   mem   - The array of memory to free
+ *   count - The number of entries in the array
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void kmm_free_bulk(FAR void *const *mem, size_t count)
+{
+  mm_free_bulk(g_kmmheap, mem, count);
+}
+
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -29,7 +29,9 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <syslog.h>
+#include <sys/param.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/kasan.h>
 #include <nuttx/mm/mempool.h>
@@ -42,6 +44,16 @@
 
 #define MEMPOOL_HEADER_SIZE (sizeof(sq_entry_t) + CONFIG_MM_NODE_GUARDSIZE)
 
+/* The per-CPU free lists are only accessed with the local interrupts
+ * disabled, which the user space heap cannot do.
+ */
+
+#if defined(CONFIG_MM_MEMPOOL_PERCPU) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MEMPOOL_HAVE_PERCPU
+#  define MEMPOOL_PERCPU_BATCH CONFIG_MM_MEMPOOL_PERCPU_BATCH
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #define MEMPOOL_MAGIC_FREE  0x55555555
 #define MEMPOOL_MAGIC_ALLOC 0xAAAAAAAA
@@ -100,6 +112,120 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+/* The blocks held by the per-CPU lists are counted as allocated in
+ * pool->nalloc.  The counts of the other CPUs are sampled without stopping
+ * them.
+ */
+
+static size_t mempool_pcpu_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += pool->pcpu[cpu].nfree;
+    }
+
+  return count;
+}
+#endif
+
+#ifdef MEMPOOL_HAVE_PERCPU
+/* Pools that wait for a free block must see every released block, so they
+ * cannot hide blocks in the per-CPU lists.
+ */
+
+static inline bool mempool_pcpu_enabled(FAR struct mempool_s *pool)
+{
+  return !pool->wait || pool->expandsize > 0;
+}
+
+static FAR sq_entry_t *mempool_pcpu_allocate(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_pcpu_s *pcpu;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  pcpu = &pool->pcpu[this_cpu()];
+  if (pcpu->nfree == 0)
+    {
+      /* Refill the list with a batch of blocks from the pool */
+
+      spin_lock(&pool->lock);
+      while (pcpu->nfree < MEMPOOL_PERCPU_BATCH)
+        {
+          blk = mempool_remove_queue(pool, &pool->queue);
+          if (blk == NULL)
+            {
+              break;
+            }
+
+          sq_addlast(blk, &pcpu->queue);
+          pcpu->nfree++;
+        }
+
+      pool->nalloc += pcpu->nfree;
+      spin_unlock(&pool->lock);
+    }
+
+  blk = mempool_remove_queue(pool, &pcpu->queue);
+  if (blk != NULL)
+    {
+      pcpu->nfree--;
+    }
+
+  up_irq_restore(flags);
+  return blk;
+}
+
+static void mempool_pcpu_release(FAR struct mempool_s *pool,
+                                 FAR sq_entry_t *blk)
+{
+  FAR struct mempool_pcpu_s *pcpu;
+  FAR sq_entry_t *last;
+  sq_queue_t spill;
+  irqstate_t flags;
+  size_t nspill;
+  size_t i;
+
+  flags = up_irq_save();
+  pcpu = &pool->pcpu[this_cpu()];
+
+  /* The most recently released block is handed out first while it is
+   * still in the cache.
+   */
+
+  sq_addfirst(blk, &pcpu->queue);
+  if (++pcpu->nfree > 2 * MEMPOOL_PERCPU_BATCH)
+    {
+      /* Keep the batch at the head and give the rest back to the pool */
+
+      last = pcpu->queue.head;
+      for (i = 1; i < MEMPOOL_PERCPU_BATCH; i++)
+        {
+          last = last->flink;
+        }
+
+      spill.head       = last->flink;
+      spill.tail       = pcpu->queue.tail;
+      last->flink      = NULL;
+      pcpu->queue.tail = last;
+      nspill           = pcpu->nfree - MEMPOOL_PERCPU_BATCH;
+      pcpu->nfree      = MEMPOOL_PERCPU_BATCH;
+
+      spin_lock(&pool->lock);
+      sq_cat(&spill, &pool->queue);
+      pool->nalloc -= nspill;
+      spin_unlock(&pool->lock);
+    }
+
+  up_irq_restore(flags);
+}
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -240,6 +366,77 @@ mempool_memdump_free_callback(FAR struct mempool_s *pool,
 }
 #endif
 
+/****************************************************************************
+ * Name: mempool_allocate_block
+ *
+ * Description:
+ *   Take a block from the free queues of the pool, expanding the pool or
+ *   waiting for a released block when they are empty.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_allocate_block(FAR struct mempool_s *pool)
+{
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+retry:
+  flags = spin_lock_irqsave(&pool->lock);
+  blk = mempool_remove_queue(pool, &pool->queue);
+  if (blk == NULL)
+    {
+      if (up_interrupt_context())
+        {
+          blk = mempool_remove_queue(pool, &pool->iqueue);
+          if (blk == NULL)
+            {
+              spin_unlock_irqrestore(&pool->lock, flags);
+              return blk;
+            }
+        }
+      else
+        {
+          size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+
+          spin_unlock_irqrestore(&pool->lock, flags);
+          if (pool->expandsize >= blocksize + MEMPOOL_HEADER_SIZE)
+            {
+              size_t nexpand = (pool->expandsize - MEMPOOL_HEADER_SIZE) /
+                               blocksize;
+              size_t size = nexpand * blocksize + MEMPOOL_HEADER_SIZE;
+              FAR char *base = pool->alloc(pool, size);
+
+              if (base == NULL)
+                {
+                  return NULL;
+                }
+
+              kasan_poison(base, size);
+              flags = spin_lock_irqsave(&pool->lock);
+              mempool_add_queue(pool, &pool->queue,
+                                base, nexpand, blocksize);
+              sq_addlast((FAR sq_entry_t *)(base + nexpand * blocksize),
+                         &pool->equeue);
+              blk = mempool_remove_queue(pool, &pool->queue);
+            }
+          else if (!pool->wait ||
+                   pool->expandsize > 0 ||
+                   nxsem_wait_uninterruptible(&pool->waitsem) < 0)
+            {
+              return NULL;
+            }
+          else
+            {
+              goto retry;
+            }
+        }
+    }
+
+  pool->nalloc++;
+  spin_unlock_irqrestore(&pool->lock, flags);
+  return blk;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -264,11 +461,24 @@ mempool_memdump_free_callback(FAR struct mempool_s *pool,
 int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  int i;
+#endif
 
   sq_init(&pool->queue);
   sq_init(&pool->iqueue);
   sq_init(&pool->equeue);
   pool->nalloc = 0;
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      sq_init(&pool->pcpu[i].queue);
+      pool->pcpu[i].nfree = 0;
+    }
+#endif
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  pool->cache = NULL;
+#endif
   if (pool->interruptsize >= blocksize)
     {
       size_t ninterrupt = pool->interruptsize / blocksize;
@@ -352,62 +562,21 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 FAR void *mempool_allocate(FAR struct mempool_s *pool)
 {
   FAR sq_entry_t *blk;
-  irqstate_t flags;
 
-retry:
-  flags = spin_lock_irqsave(&pool->lock);
-  blk = mempool_remove_queue(pool, &pool->queue);
+#ifdef MEMPOOL_HAVE_PERCPU
+  blk = mempool_pcpu_enabled(pool) ? mempool_pcpu_allocate(pool) : NULL;
   if (blk == NULL)
     {
-      if (up_interrupt_context())
-        {
-          blk = mempool_remove_queue(pool, &pool->iqueue);
-          if (blk == NULL)
-            {
-              spin_unlock_irqrestore(&pool->lock, flags);
-              return blk;
-            }
-        }
-      else
-        {
-          size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
-
-          spin_unlock_irqrestore(&pool->lock, flags);
-          if (pool->expandsize >= blocksize + MEMPOOL_HEADER_SIZE)
-            {
-              size_t nexpand = (pool->expandsize - MEMPOOL_HEADER_SIZE) /
-                               blocksize;
-              size_t size = nexpand * blocksize + MEMPOOL_HEADER_SIZE;
-              FAR char *base = pool->alloc(pool, size);
-
-              if (base == NULL)
-                {
-                  return NULL;
-                }
-
-              kasan_poison(base, size);
-              flags = spin_lock_irqsave(&pool->lock);
-              mempool_add_queue(pool, &pool->queue,
-                                base, nexpand, blocksize);
-              sq_addlast((FAR sq_entry_t *)(base + nexpand * blocksize),
-                         &pool->equeue);
-              blk = mempool_remove_queue(pool, &pool->queue);
-            }
-          else if (!pool->wait ||
-                   pool->expandsize > 0 ||
-                   nxsem_wait_uninterruptible(&pool->waitsem) < 0)
-            {
-              return NULL;
-            }
-          else
-            {
-              goto retry;
-            }
-        }
+      blk = mempool_allocate_block(pool);
     }
+#else
+  blk = mempool_allocate_block(pool);
+#endif
 
-  pool->nalloc++;
-  spin_unlock_irqrestore(&pool->lock, flags);
+  if (blk == NULL)
+    {
+      return NULL;
+    }
 
 #if CONFIG_MM_BACKTRACE >= 0
   mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
@@ -435,7 +604,7 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
@@ -447,12 +616,26 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 
 #endif
 
-  pool->nalloc--;
-
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_FREE_MAGIC, pool->blocksize);
 #endif
 
+#ifdef MEMPOOL_HAVE_PERCPU
+  /* The blocks reserved for the interrupt handlers go back to the pool */
+
+  if (mempool_pcpu_enabled(pool) &&
+      (pool->ibase == NULL || (FAR char *)blk < pool->ibase ||
+       (FAR char *)blk >= pool->ibase + pool->interruptsize))
+    {
+      kasan_poison(blk, pool->blocksize);
+      mempool_pcpu_release(pool, blk);
+      return;
+    }
+#endif
+
+  flags = spin_lock_irqsave(&pool->lock);
+  pool->nalloc--;
+
   if (pool->ibase)
     {
       if ((FAR char *)blk >= pool->ibase &&
@@ -501,6 +684,9 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  size_t ncached;
+#endif
   irqstate_t flags;
 
   DEBUGASSERT(pool != NULL && info != NULL);
@@ -513,6 +699,45 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
   info->sizeblks = blocksize;
+
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  ncached = MIN(mempool_pcpu_count(pool), info->aordblks);
+  info->aordblks -= ncached;
+  info->ordblks  += ncached;
+#endif
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  info->nhit = 0;
+  info->nmiss = 0;
+  if (pool->cache != NULL)
+    {
+      FAR struct mempool_cache_s *cache = pool->cache;
+      unsigned long ncached;
+      int cpu;
+
+      /* The blocks held by the magazines are allocated from the pool but
+       * free for the users.  The per-CPU counts are sampled without
+       * stopping the other CPUs.
+       */
+
+      flags = spin_lock_irqsave(&cache->lock);
+      ncached = sq_count(&cache->full) * CONFIG_MM_HEAP_MEMPOOL_MAGAZINE_SIZE;
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          ncached     += cache->cpu[cpu].loaded->nrounds +
+                         cache->cpu[cpu].previous->nrounds;
+          info->nhit  += cache->cpu[cpu].nhit;
+          info->nmiss += cache->cpu[cpu].nmiss;
+        }
+
+      ncached = MIN(ncached, info->aordblks);
+      info->aordblks -= ncached;
+      info->ordblks  += ncached;
+    }
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       int semcount;
@@ -549,13 +774,21 @@ mempool_info_task(FAR struct mempool_s *pool,
                      sq_count(&pool->iqueue);
 
       spin_unlock_irqrestore(&pool->lock, flags);
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+      count += mempool_pcpu_count(pool);
+#endif
       info.aordblks += count;
       info.uordblks += count * blocksize;
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc;
+
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+      count -= MIN(mempool_pcpu_count(pool), count);
+#endif
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -609,6 +842,168 @@ void mempool_memdump(FAR struct mempool_s *pool,
 #endif
 }
 
+/****************************************************************************
+ * Name: mempool_drain
+ *
+ * Description:
+ *   Return the free blocks cached by the calling CPU to the pool.
+ *
+ * Input Parameters:
+ *   pool    - Address of the memory pool to be used.
+ ****************************************************************************/
+
+void mempool_drain(FAR struct mempool_s *pool)
+{
+#ifdef MEMPOOL_HAVE_PERCPU
+  FAR struct mempool_pcpu_s *pcpu;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  pcpu = &pool->pcpu[this_cpu()];
+  if (pcpu->nfree > 0)
+    {
+      spin_lock(&pool->lock);
+      sq_cat(&pcpu->queue, &pool->queue);
+      pool->nalloc -= pcpu->nfree;
+      spin_unlock(&pool->lock);
+      pcpu->nfree = 0;
+    }
+
+  up_irq_restore(flags);
+#else
+  UNUSED(pool);
+#endif
+}
+
+/****************************************************************************
+ * Name: mempool_shrink
+ *
+ * Description:
+ *   Release the expansions of the pool whose blocks are all free.  The
+ *   initial blocks and the blocks reserved for the interrupt handlers are
+ *   kept.
+ *
+ * Input Parameters:
+ *   pool    - Address of the memory pool to be used.
+ *
+ * Returned Value:
+ *   The number of bytes released.
+ ****************************************************************************/
+
+size_t mempool_shrink(FAR struct mempool_s *pool)
+{
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  FAR sq_entry_t *expand;
+  FAR sq_entry_t *next;
+  FAR sq_entry_t *prev;
+  FAR sq_entry_t *blk;
+  FAR sq_entry_t *blkprev;
+  sq_queue_t released;
+  irqstate_t flags;
+  FAR char *base;
+  size_t nexpand;
+  size_t nfree;
+  size_t size;
+  size_t ret = 0;
+
+  if (pool->expandsize < blocksize + MEMPOOL_HEADER_SIZE)
+    {
+      return 0;
+    }
+
+  nexpand = (pool->expandsize - MEMPOOL_HEADER_SIZE) / blocksize;
+  size = nexpand * blocksize + MEMPOOL_HEADER_SIZE;
+  sq_init(&released);
+
+  flags = spin_lock_irqsave(&pool->lock);
+
+  /* The initial blocks are the first entry of equeue */
+
+  prev = NULL;
+  expand = sq_peek(&pool->equeue);
+  if (expand != NULL &&
+      pool->initialsize >= blocksize + MEMPOOL_HEADER_SIZE)
+    {
+      prev = expand;
+      expand = sq_next(expand);
+    }
+
+  while (expand != NULL)
+    {
+      next = sq_next(expand);
+      base = (FAR char *)expand - nexpand * blocksize;
+
+      nfree = 0;
+      sq_for_every(&pool->queue, blk)
+        {
+          if ((FAR char *)blk >= base && (FAR char *)blk < (FAR char *)expand)
+            {
+              nfree++;
+            }
+        }
+
+      if (nfree < nexpand)
+        {
+          prev = expand;
+          expand = next;
+          continue;
+        }
+
+      /* Take the blocks and then the expansion itself out of the pool */
+
+      blkprev = NULL;
+      blk = sq_peek(&pool->queue);
+      while (blk != NULL && nfree > 0)
+        {
+          FAR sq_entry_t *blknext = sq_next(blk);
+
+          if ((FAR char *)blk >= base && (FAR char *)blk < (FAR char *)expand)
+            {
+              if (blkprev == NULL)
+                {
+                  sq_remfirst(&pool->queue);
+                }
+              else
+                {
+                  sq_remafter(blkprev, &pool->queue);
+                }
+
+              nfree--;
+            }
+          else
+            {
+              blkprev = blk;
+            }
+
+          blk = blknext;
+        }
+
+      if (prev == NULL)
+        {
+          sq_remfirst(&pool->equeue);
+        }
+      else
+        {
+          sq_remafter(prev, &pool->equeue);
+        }
+
+      sq_addlast(expand, &released);
+      expand = next;
+    }
+
+  spin_unlock_irqrestore(&pool->lock, flags);
+
+  while ((expand = sq_remfirst(&released)) != NULL)
+    {
+      base = (FAR char *)expand - nexpand * blocksize;
+      base = kasan_unpoison(base, size);
+      pool->free(pool, base);
+      ret += size;
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: mempool_deinit
  *
@@ -624,6 +1019,18 @@ int mempool_deinit(FAR struct mempool_s *pool)
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   FAR sq_entry_t *blk;
   size_t count = 0;
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  int cpu;
+
+  /* Give the blocks held by the per-CPU lists back to the pool */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      sq_cat(&pool->pcpu[cpu].queue, &pool->queue);
+      pool->nalloc -= pool->pcpu[cpu].nfree;
+      pool->pcpu[cpu].nfree = 0;
+    }
+#endif
 
   if (pool->nalloc != 0)
     {
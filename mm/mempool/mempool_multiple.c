@@ -34,6 +34,27 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/mempool.h>
 #include <nuttx/mm/kasan.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The magazine cache disables the local interrupts, so it is only built for
+ * the heaps of the kernel (or of a flat build).
+ */
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_MAGAZINE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MEMPOOL_HAVE_MAGAZINE
+
+/* Every CPU owns two magazines of each pool, the depot holds the rest */
+
+#  define MEMPOOL_NMAGAZINES (2 * CONFIG_SMP_NCPUS + \
+                              CONFIG_MM_HEAP_MEMPOOL_MAGAZINE_DEPOT)
+#endif
 
 /****************************************************************************
  * Private Types
@@ -90,6 +111,7 @@ struct mempool_multiple_s
   sq_queue_t                    chunk_queue;
   size_t                        chunk_size;
   size_t                        dict_used;
+  size_t                        dict_free;
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
@@ -234,6 +256,7 @@ static FAR void *mempool_multiple_alloc_callback(FAR struct mempool_s *pool,
 {
   FAR struct mempool_multiple_s *mpool = pool->priv;
   FAR void *ret;
+  size_t index;
   size_t row;
   size_t col;
 
@@ -246,26 +269,46 @@ static FAR void *mempool_multiple_alloc_callback(FAR struct mempool_s *pool,
       return NULL;
     }
 
-  row = mpool->dict_used >> mpool->dict_col_num_log2;
+  if (mpool->dict_free > 0)
+    {
+      /* Reuse the entry of a released expansion */
+
+      for (index = 0; ; index++)
+        {
+          row = index >> mpool->dict_col_num_log2;
+          col = index - (row << mpool->dict_col_num_log2);
+          if (mpool->dict[row][col].pool == NULL)
+            {
+              break;
+            }
+        }
+
+      mpool->dict_free--;
+    }
+  else
+    {
+      index = mpool->dict_used++;
+      row = index >> mpool->dict_col_num_log2;
 
-  /* There is no new pointer address to store the dictionaries */
+      /* There is no new pointer address to store the dictionaries */
 
-  DEBUGASSERT(mpool->dict_row_num > row);
+      DEBUGASSERT(mpool->dict_row_num > row);
 
-  col = mpool->dict_used - (row << mpool->dict_col_num_log2);
+      col = index - (row << mpool->dict_col_num_log2);
 
-  if (mpool->dict[row] == NULL)
-    {
-      mpool->dict[row] =
-        mempool_multiple_alloc_chunk(mpool, sizeof(uintptr_t),
-                                     (1 << mpool->dict_col_num_log2)
-                                     * sizeof(struct mpool_dict_s));
+      if (mpool->dict[row] == NULL)
+        {
+          mpool->dict[row] =
+            mempool_multiple_alloc_chunk(mpool, sizeof(uintptr_t),
+                                         (1 << mpool->dict_col_num_log2)
+                                         * sizeof(struct mpool_dict_s));
+        }
     }
 
   mpool->dict[row][col].pool = pool;
   mpool->dict[row][col].addr = ret;
   mpool->dict[row][col].size = mpool->minpoolsize + size;
-  *(FAR size_t *)ret = mpool->dict_used++;
+  *(FAR size_t *)ret = index;
   nxrmutex_unlock(&mpool->lock);
   return (FAR char *)ret + mpool->minpoolsize;
 }
@@ -274,9 +317,20 @@ static void mempool_multiple_free_callback(FAR struct mempool_s *pool,
                                            FAR void *addr)
 {
   FAR struct mempool_multiple_s *mpool = pool->priv;
+  FAR char *base = (FAR char *)addr - mpool->minpoolsize;
+  size_t index = *(FAR size_t *)base;
+  size_t row = index >> mpool->dict_col_num_log2;
+  size_t col = index - (row << mpool->dict_col_num_log2);
 
-  mempool_multiple_free_chunk(mpool,
-                              (FAR char *)addr - mpool->minpoolsize);
+  /* Forget the expansion, the heap may reuse its memory */
+
+  nxrmutex_lock(&mpool->lock);
+  mpool->dict[row][col].pool = NULL;
+  mpool->dict[row][col].addr = NULL;
+  mpool->dict_free++;
+  nxrmutex_unlock(&mpool->lock);
+
+  mempool_multiple_free_chunk(mpool, base);
 }
 
 /****************************************************************************
@@ -358,6 +412,317 @@ static void mempool_multiple_check(FAR struct mempool_s *pool,
   assert(mempool_multiple_get_dict(pool->priv, blk));
 }
 
+#ifdef MEMPOOL_HAVE_MAGAZINE
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_init
+ *
+ * Description:
+ *   Create the magazine cache of a pool.  All magazines are allocated here
+ *   and start empty: two for each CPU and the rest in the depot.
+ *
+ ****************************************************************************/
+
+static int mempool_multiple_cache_init(FAR struct mempool_multiple_s *mpool,
+                                       FAR struct mempool_s *pool)
+{
+  FAR struct mempool_magazine_s *mag;
+  FAR struct mempool_cache_s *cache;
+  int i;
+
+  cache = mempool_multiple_alloc_chunk(mpool, sizeof(uintptr_t),
+                                       sizeof(struct mempool_cache_s) +
+                                       MEMPOOL_NMAGAZINES *
+                                       sizeof(struct mempool_magazine_s));
+  if (cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(cache, 0, sizeof(struct mempool_cache_s));
+  spin_lock_init(&cache->lock);
+  sq_init(&cache->full);
+  sq_init(&cache->empty);
+
+  mag = (FAR struct mempool_magazine_s *)(cache + 1);
+  for (i = 0; i < MEMPOOL_NMAGAZINES; i++, mag++)
+    {
+      mag->nrounds = 0;
+      if (i < CONFIG_SMP_NCPUS)
+        {
+          cache->cpu[i].loaded = mag;
+        }
+      else if (i < 2 * CONFIG_SMP_NCPUS)
+        {
+          cache->cpu[i - CONFIG_SMP_NCPUS].previous = mag;
+        }
+      else
+        {
+          sq_addlast(&mag->entry, &cache->empty);
+        }
+    }
+
+  pool->cache = cache;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_empty
+ *
+ * Description:
+ *   Return the blocks held by a magazine to the pool.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_cache_empty(FAR struct mempool_s *pool,
+                                         FAR struct mempool_magazine_s *mag)
+{
+  while (mag->nrounds > 0)
+    {
+      FAR void *blk = mag->rounds[--mag->nrounds];
+
+      mempool_release(pool, kasan_unpoison(blk, pool->blocksize));
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_drain
+ *
+ * Description:
+ *   Return the blocks held by the magazines of this CPU and by the full
+ *   magazines of the depot to the pool.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_cache_drain(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache = pool->cache;
+  FAR struct mempool_cpucache_s *cpucache;
+  FAR struct mempool_magazine_s *mag;
+  irqstate_t flags;
+
+  if (cache == NULL)
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+  cpucache = &cache->cpu[this_cpu()];
+  mempool_multiple_cache_empty(pool, cpucache->loaded);
+  mempool_multiple_cache_empty(pool, cpucache->previous);
+
+  spin_lock(&cache->lock);
+  while ((mag = (FAR struct mempool_magazine_s *)
+                sq_remfirst(&cache->full)) != NULL)
+    {
+      mempool_multiple_cache_empty(pool, mag);
+      sq_addlast(&mag->entry, &cache->empty);
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_flush
+ *
+ * Description:
+ *   Return the blocks held by all magazines of a pool to the pool and
+ *   release the magazine cache.  The pool must not be used any more.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_cache_flush(FAR struct mempool_multiple_s *mpool,
+                                         FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache = pool->cache;
+  FAR struct mempool_magazine_s *mag;
+  int i;
+
+  if (cache == NULL)
+    {
+      return;
+    }
+
+  pool->cache = NULL;
+
+  mag = (FAR struct mempool_magazine_s *)(cache + 1);
+  for (i = 0; i < MEMPOOL_NMAGAZINES; i++, mag++)
+    {
+      mempool_multiple_cache_empty(pool, mag);
+    }
+
+  mempool_multiple_free_chunk(mpool, cache);
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_get
+ *
+ * Description:
+ *   Take a free block of the pool from the magazines of this CPU.  When
+ *   both magazines are empty, the empty one is exchanged for a full
+ *   magazine of the depot.  Only the depot exchange takes a shared lock.
+ *
+ * Returned Value:
+ *   The block, or NULL if the magazines and the depot are empty.
+ *
+ ****************************************************************************/
+
+static FAR void *mempool_multiple_cache_get(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache = pool->cache;
+  FAR struct mempool_cpucache_s *cpucache;
+  FAR struct mempool_magazine_s *mag;
+  FAR void *blk = NULL;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  cpucache = &cache->cpu[this_cpu()];
+  mag = cpucache->loaded;
+
+  if (mag->nrounds == 0)
+    {
+      if (cpucache->previous->nrounds > 0)
+        {
+          cpucache->loaded   = cpucache->previous;
+          cpucache->previous = mag;
+        }
+      else
+        {
+          spin_lock(&cache->lock);
+          mag = (FAR struct mempool_magazine_s *)sq_remfirst(&cache->full);
+          if (mag != NULL)
+            {
+              sq_addlast(&cpucache->previous->entry, &cache->empty);
+              cpucache->previous = cpucache->loaded;
+              cpucache->loaded   = mag;
+            }
+
+          spin_unlock(&cache->lock);
+        }
+
+      mag = cpucache->loaded;
+    }
+
+  if (mag->nrounds > 0)
+    {
+      blk = mag->rounds[--mag->nrounds];
+      cpucache->nhit++;
+    }
+  else
+    {
+      cpucache->nmiss++;
+    }
+
+  up_irq_restore(flags);
+
+  if (blk != NULL)
+    {
+      blk = kasan_unpoison(blk, pool->blocksize);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(blk, MM_ALLOC_MAGIC, pool->blocksize);
+#endif
+    }
+
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_put
+ *
+ * Description:
+ *   Put a block of the pool into the magazines of this CPU.  When both
+ *   magazines are full, the full one is exchanged for an empty magazine of
+ *   the depot so that the blocks freed on one CPU can be allocated on
+ *   another.
+ *
+ * Returned Value:
+ *   True if the block is cached, false if it must be released to the pool.
+ *
+ ****************************************************************************/
+
+static bool mempool_multiple_cache_put(FAR struct mempool_s *pool,
+                                       FAR void *blk)
+{
+  FAR struct mempool_cache_s *cache = pool->cache;
+  FAR struct mempool_cpucache_s *cpucache;
+  FAR struct mempool_magazine_s *mag;
+  irqstate_t flags;
+  bool ret = false;
+
+  flags = up_irq_save();
+  cpucache = &cache->cpu[this_cpu()];
+  mag = cpucache->loaded;
+
+  if (mag->nrounds == CONFIG_MM_HEAP_MEMPOOL_MAGAZINE_SIZE)
+    {
+      if (cpucache->previous->nrounds < CONFIG_MM_HEAP_MEMPOOL_MAGAZINE_SIZE)
+        {
+          cpucache->loaded   = cpucache->previous;
+          cpucache->previous = mag;
+        }
+      else
+        {
+          spin_lock(&cache->lock);
+          mag = (FAR struct mempool_magazine_s *)sq_remfirst(&cache->empty);
+          if (mag != NULL)
+            {
+              sq_addlast(&cpucache->previous->entry, &cache->full);
+              cpucache->previous = cpucache->loaded;
+              cpucache->loaded   = mag;
+            }
+
+          spin_unlock(&cache->lock);
+        }
+
+      mag = cpucache->loaded;
+    }
+
+  if (mag->nrounds < CONFIG_MM_HEAP_MEMPOOL_MAGAZINE_SIZE)
+    {
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(blk, MM_FREE_MAGIC, pool->blocksize);
+#endif
+      kasan_poison(blk, pool->blocksize);
+      mag->rounds[mag->nrounds++] = blk;
+      cpucache->nhit++;
+      ret = true;
+    }
+  else
+    {
+      cpucache->nmiss++;
+    }
+
+  up_irq_restore(flags);
+  return ret;
+}
+
+#endif /* MEMPOOL_HAVE_MAGAZINE */
+
+/****************************************************************************
+ * Name: mempool_multiple_drain
+ *
+ * Description:
+ *   Return the blocks cached by this CPU to the pools.
+ *
+ ****************************************************************************/
+
+static int mempool_multiple_drain(FAR void *arg)
+{
+  FAR struct mempool_multiple_s *mpool = arg;
+  size_t i;
+
+  for (i = 0; i < mpool->npools; i++)
+    {
+#ifdef MEMPOOL_HAVE_MAGAZINE
+      mempool_multiple_cache_drain(mpool->pools + i);
+#endif
+      mempool_drain(mpool->pools + i);
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -474,6 +839,15 @@ mempool_multiple_init(FAR const char *name,
           goto err_with_pools;
         }
 
+#ifdef MEMPOOL_HAVE_MAGAZINE
+      ret = mempool_multiple_cache_init(mpool, pools + i);
+      if (ret < 0)
+        {
+          mempool_deinit(pools + i);
+          goto err_with_pools;
+        }
+#endif
+
       if (i + 1 != npools)
         {
           size_t delta = poolsize[i + 1] - poolsize[i];
@@ -490,6 +864,7 @@ mempool_multiple_init(FAR const char *name,
     }
 
   mpool->dict_used = 0;
+  mpool->dict_free = 0;
   mpool->dict_col_num_log2 = fls(dict_expendsize /
                                  sizeof(struct mpool_dict_s));
 
@@ -511,6 +886,9 @@ mempool_multiple_init(FAR const char *name,
 err_with_pools:
   while (--i >= 0)
     {
+#ifdef MEMPOOL_HAVE_MAGAZINE
+      mempool_multiple_cache_flush(mpool, pools + i);
+#endif
       mempool_deinit(pools + i);
     }
 
@@ -548,6 +926,18 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
       return NULL;
     }
 
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  if (pool->cache != NULL)
+    {
+      FAR void *blk = mempool_multiple_cache_get(pool);
+
+      if (blk)
+        {
+          return blk;
+        }
+    }
+#endif
+
   end = mpool->pools + mpool->npools;
   do
     {
@@ -638,6 +1028,15 @@ int mempool_multiple_free(FAR struct mempool_multiple_s *mpool,
                             ((FAR char *)kasan_clear_tag(dict->addr) +
                              mpool->minpoolsize)) %
                            MEMPOOL_REALBLOCKSIZE(dict->pool));
+
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  if (dict->pool->cache != NULL &&
+      mempool_multiple_cache_put(dict->pool, blk))
+    {
+      return 0;
+    }
+#endif
+
   mempool_release(dict->pool, blk);
   return 0;
 }
@@ -728,6 +1127,51 @@ FAR void *mempool_multiple_memalign(FAR struct mempool_multiple_s *mpool,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: mempool_multiple_shrink
+ *
+ * Description:
+ *   Return the blocks cached by all CPUs to the pools and release the
+ *   expansions whose blocks are all free.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ * Returned Value:
+ *   The number of bytes released.
+ *
+ ****************************************************************************/
+
+size_t mempool_multiple_shrink(FAR struct mempool_multiple_s *mpool)
+{
+  size_t ret = 0;
+  size_t i;
+
+  /* The lock is held while the pools allocate memory, which may reclaim */
+
+  if (mpool == NULL || nxrmutex_trylock(&mpool->lock) < 0)
+    {
+      return 0;
+    }
+
+  /* The caches of a CPU are only touched by that CPU */
+
+#ifdef CONFIG_SMP
+  nxsched_smp_call((1 << CONFIG_SMP_NCPUS) - 1,
+                   mempool_multiple_drain, mpool);
+#else
+  mempool_multiple_drain(mpool);
+#endif
+
+  for (i = 0; i < mpool->npools; i++)
+    {
+      ret += mempool_shrink(mpool->pools + i);
+    }
+
+  nxrmutex_unlock(&mpool->lock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: mempool_multiple_foreach
  ****************************************************************************/
@@ -876,6 +1320,9 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
 
   for (i = 0; i < mpool->npools; i++)
     {
+#ifdef MEMPOOL_HAVE_MAGAZINE
+      mempool_multiple_cache_flush(mpool, mpool->pools + i);
+#endif
       DEBUGVERIFY(mempool_deinit(mpool->pools + i));
     }
 
@@ -33,7 +33,7 @@
 
 #include "mm_gran/mm_gran.h"
 
-#ifdef CONFIG_MM_PGALLOC
+#if defined(CONFIG_MM_PGALLOC) && !defined(CONFIG_MM_PGALLOC_BUDDY)
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -224,4 +224,4 @@ void mm_pginfo(FAR struct pginfo_s *info)
   info->mxfree = graninfo.mxfree;
 }
 
-#endif /* CONFIG_MM_PGALLOC */
+#endif /* CONFIG_MM_PGALLOC && !CONFIG_MM_PGALLOC_BUDDY */
@@ -0,0 +1,600 @@
+/****************************************************************************
+ * mm/mm_gran/mm_pgbuddy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/param.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_MM_PGALLOC_BUDDY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Debug */
+
+#ifdef CONFIG_DEBUG_PGALLOC
+#  define pgaerr                    _err
+#  define pgawarn                   _warn
+#  define pgainfo                   _info
+#else
+#  define pgaerr                    merr
+#  define pgawarn                   mwarn
+#  define pgainfo                   minfo
+#endif
+
+/* Blocks are of 2^0 .. 2^PGBUDDY_MAXORDER pages.  A block of order k
+ * starts at a physical page number that is a multiple of 2^k, so a block
+ * is aligned to its size in physical memory and not only relative to the
+ * start of the page pool.
+ */
+
+#define PGBUDDY_MAXORDER            CONFIG_MM_PGALLOC_MAXORDER
+#define PGBUDDY_NORDERS             (PGBUDDY_MAXORDER + 1)
+#define PGBUDDY_NONE                UINT32_MAX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The free lists are linked through this per-page state, which lives in
+ * the kernel heap because the pages themselves may not be mapped.  Only
+ * the first page of a free block is on a free list.
+ */
+
+struct pgbuddy_page_s
+{
+  uint32_t flink;                   /* Next free block of the same order */
+  uint32_t blink;                   /* Previous free block */
+  uint8_t  order;                   /* Order of the free block */
+  bool     free;                    /* A free block starts at this page */
+};
+
+struct pgbuddy_s
+{
+  spinlock_t lock;                  /* Protects the page allocator */
+  uintptr_t  pfnbase;               /* Page number of the first page */
+  uint32_t   npages;                /* Number of pages in the pool */
+  uint32_t   nfree;                 /* Number of free pages */
+  uint32_t   freelist[PGBUDDY_NORDERS]; /* Free blocks of each order */
+  FAR struct pgbuddy_page_s *page;  /* State of each page */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The state of the page allocator */
+
+static struct pgbuddy_s g_pgbuddy;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pgbuddy_order
+ *
+ * Description:
+ *   Return the order of the smallest block that holds 'npages' pages.
+ *
+ ****************************************************************************/
+
+static unsigned int pgbuddy_order(size_t npages)
+{
+  unsigned int order = 0;
+
+  while (((size_t)1 << order) < npages)
+    {
+      order++;
+    }
+
+  return order;
+}
+
+/****************************************************************************
+ * Name: pgbuddy_insert
+ *
+ * Description:
+ *   Add the free block of 'order' starting at page index 'ndx' to its
+ *   free list.
+ *
+ ****************************************************************************/
+
+static void pgbuddy_insert(uint32_t ndx, unsigned int order)
+{
+  FAR struct pgbuddy_page_s *page = &g_pgbuddy.page[ndx];
+  uint32_t head = g_pgbuddy.freelist[order];
+
+  page->flink = head;
+  page->blink = PGBUDDY_NONE;
+  page->order = order;
+  page->free  = true;
+
+  if (head != PGBUDDY_NONE)
+    {
+      g_pgbuddy.page[head].blink = ndx;
+    }
+
+  g_pgbuddy.freelist[order] = ndx;
+}
+
+/****************************************************************************
+ * Name: pgbuddy_remove
+ *
+ * Description:
+ *   Remove the free block starting at page index 'ndx' from its free list.
+ *
+ ****************************************************************************/
+
+static void pgbuddy_remove(uint32_t ndx)
+{
+  FAR struct pgbuddy_page_s *page = &g_pgbuddy.page[ndx];
+
+  if (page->blink != PGBUDDY_NONE)
+    {
+      g_pgbuddy.page[page->blink].flink = page->flink;
+    }
+  else
+    {
+      g_pgbuddy.freelist[page->order] = page->flink;
+    }
+
+  if (page->flink != PGBUDDY_NONE)
+    {
+      g_pgbuddy.page[page->flink].blink = page->blink;
+    }
+
+  page->free = false;
+}
+
+/****************************************************************************
+ * Name: pgbuddy_freeblock
+ *
+ * Description:
+ *   Free the block of 'order' starting at page index 'ndx', merging it
+ *   with its buddy for as long as the buddy is free as well.
+ *
+ ****************************************************************************/
+
+static void pgbuddy_freeblock(uint32_t ndx, unsigned int order)
+{
+  uintptr_t pfn = g_pgbuddy.pfnbase + ndx;
+  uintptr_t buddy;
+
+  while (order < PGBUDDY_MAXORDER)
+    {
+      buddy = pfn ^ ((uintptr_t)1 << order);
+      if (buddy < g_pgbuddy.pfnbase ||
+          buddy - g_pgbuddy.pfnbase >= g_pgbuddy.npages ||
+          !g_pgbuddy.page[buddy - g_pgbuddy.pfnbase].free ||
+          g_pgbuddy.page[buddy - g_pgbuddy.pfnbase].order != order)
+        {
+          break;
+        }
+
+      pgbuddy_remove(buddy - g_pgbuddy.pfnbase);
+      pfn &= ~((uintptr_t)1 << order);
+      order++;
+    }
+
+  pgbuddy_insert(pfn - g_pgbuddy.pfnbase, order);
+}
+
+/****************************************************************************
+ * Name: pgbuddy_freerange
+ *
+ * Description:
+ *   Free 'npages' pages starting at page index 'ndx' as the largest
+ *   aligned blocks they are made of.
+ *
+ ****************************************************************************/
+
+static void pgbuddy_freerange(uint32_t ndx, size_t npages)
+{
+  uintptr_t pfn = g_pgbuddy.pfnbase + ndx;
+  unsigned int order;
+
+  g_pgbuddy.nfree += npages;
+
+  while (npages > 0)
+    {
+      order = 0;
+      while (order < PGBUDDY_MAXORDER &&
+             (pfn & ((uintptr_t)1 << order)) == 0 &&
+             ((size_t)2 << order) <= npages)
+        {
+          order++;
+        }
+
+      pgbuddy_freeblock(pfn - g_pgbuddy.pfnbase, order);
+      pfn    += (uintptr_t)1 << order;
+      npages -= (size_t)1 << order;
+    }
+}
+
+/****************************************************************************
+ * Name: pgbuddy_alloc
+ *
+ * Description:
+ *   Allocate 'npages' pages from a block of at least 'order', returning
+ *   the pages of the block beyond 'npages'.  The page index of the first
+ *   page is returned, PGBUDDY_NONE if there is no such block.
+ *
+ ****************************************************************************/
+
+static uint32_t pgbuddy_alloc(size_t npages, unsigned int order)
+{
+  unsigned int found;
+  uint32_t ndx;
+
+  for (found = order; found <= PGBUDDY_MAXORDER; found++)
+    {
+      if (g_pgbuddy.freelist[found] != PGBUDDY_NONE)
+        {
+          break;
+        }
+    }
+
+  if (found > PGBUDDY_MAXORDER)
+    {
+      return PGBUDDY_NONE;
+    }
+
+  ndx = g_pgbuddy.freelist[found];
+  pgbuddy_remove(ndx);
+  g_pgbuddy.nfree -= (uint32_t)1 << found;
+
+  /* Return the upper halves down to the requested order, then the tail of
+   * the block that is not needed for 'npages'.
+   */
+
+  while (found > order)
+    {
+      found--;
+      pgbuddy_insert(ndx + ((uint32_t)1 << found), found);
+      g_pgbuddy.nfree += (uint32_t)1 << found;
+    }
+
+  if (npages < ((size_t)1 << order))
+    {
+      pgbuddy_freerange(ndx + npages, ((size_t)1 << order) - npages);
+    }
+
+  return ndx;
+}
+
+/****************************************************************************
+ * Name: pgbuddy_find
+ *
+ * Description:
+ *   Return the page index of the free block containing the page index
+ *   'ndx', PGBUDDY_NONE if the page is not free.
+ *
+ ****************************************************************************/
+
+static uint32_t pgbuddy_find(uint32_t ndx)
+{
+  uintptr_t pfn = g_pgbuddy.pfnbase + ndx;
+  uintptr_t head;
+  unsigned int order;
+
+  for (order = 0; order <= PGBUDDY_MAXORDER; order++)
+    {
+      head = pfn & ~(((uintptr_t)1 << order) - 1);
+      if (head < g_pgbuddy.pfnbase)
+        {
+          break;
+        }
+
+      if (g_pgbuddy.page[head - g_pgbuddy.pfnbase].free &&
+          g_pgbuddy.page[head - g_pgbuddy.pfnbase].order == order)
+        {
+          return head - g_pgbuddy.pfnbase;
+        }
+    }
+
+  return PGBUDDY_NONE;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_pginitialize
+ *
+ * Description:
+ *   Initialize the page allocator.
+ *
+ * Input Parameters:
+ *   heap_start - The physical address of the start of memory region that
+ *                will be used for the page allocator heap
+ *   heap_size  - The size (in bytes) of the memory region that will be used
+ *                for the page allocator heap.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_pginitialize(FAR void *heap_start, size_t heap_size)
+{
+  uintptr_t start = MM_PGALIGNUP(heap_start);
+  uintptr_t end   = MM_PGALIGNDOWN((uintptr_t)heap_start + heap_size);
+  unsigned int order;
+
+  DEBUGASSERT(end > start);
+
+  g_pgbuddy.pfnbase = start >> MM_PGSHIFT;
+  g_pgbuddy.npages  = (end - start) >> MM_PGSHIFT;
+  g_pgbuddy.nfree   = 0;
+  g_pgbuddy.page    = kmm_zalloc(g_pgbuddy.npages *
+                                 sizeof(struct pgbuddy_page_s));
+  DEBUGASSERT(g_pgbuddy.page != NULL);
+
+  spin_lock_init(&g_pgbuddy.lock);
+
+  for (order = 0; order <= PGBUDDY_MAXORDER; order++)
+    {
+      g_pgbuddy.freelist[order] = PGBUDDY_NONE;
+    }
+
+  pgbuddy_freerange(0, g_pgbuddy.npages);
+}
+
+/****************************************************************************
+ * Name: mm_pgreserve
+ *
+ * Description:
+ *   Reserve memory in the page memory pool.  This will reserve the pages
+ *   that contain the start and end addresses plus all of the pages
+ *   in between.  This should be done early in the initialization sequence
+ *   before any other allocations are made.
+ *
+ *   Reserved memory can never be allocated (it can be freed however which
+ *   essentially unreserves the memory).
+ *
+ * Input Parameters:
+ *   start  - The address of the beginning of the region to be reserved.
+ *   size   - The size of the region to be reserved
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_pgreserve(uintptr_t start, size_t size)
+{
+  uintptr_t first = MM_PGALIGNDOWN(start) >> MM_PGSHIFT;
+  uintptr_t last  = MM_PGALIGNUP(start + size) >> MM_PGSHIFT;
+  irqstate_t flags;
+  uint32_t blkend;
+  uint32_t head;
+  uint32_t ndx;
+  uint32_t end;
+
+  /* Only the part of the region inside of the page pool is reserved */
+
+  first = MAX(first, g_pgbuddy.pfnbase);
+  last  = MIN(last, g_pgbuddy.pfnbase + g_pgbuddy.npages);
+  if (first >= last)
+    {
+      return;
+    }
+
+  ndx = first - g_pgbuddy.pfnbase;
+  end = last - g_pgbuddy.pfnbase;
+
+  flags = spin_lock_irqsave(&g_pgbuddy.lock);
+
+  /* Take every free block overlapping the region and return the parts of
+   * it outside of the region.
+   */
+
+  while (ndx < end)
+    {
+      head = pgbuddy_find(ndx);
+      if (head == PGBUDDY_NONE)
+        {
+          ndx++;
+          continue;
+        }
+
+      blkend = head + ((uint32_t)1 << g_pgbuddy.page[head].order);
+      pgbuddy_remove(head);
+      g_pgbuddy.nfree -= blkend - head;
+
+      if (head < ndx)
+        {
+          pgbuddy_freerange(head, ndx - head);
+        }
+
+      if (blkend > end)
+        {
+          pgbuddy_freerange(end, blkend - end);
+        }
+
+      ndx = blkend;
+    }
+
+  spin_unlock_irqrestore(&g_pgbuddy.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_pgalloc
+ *
+ * Description:
+ *   Allocate page memory from the page memory pool.
+ *
+ * Input Parameters:
+ *   npages - The number of pages to allocate, each of size CONFIG_MM_PGSIZE.
+ *
+ * Returned Value:
+ *   On success, a non-zero, physical address of the allocated page memory
+ *   is returned.  Zero is returned on failure.  NOTE:  This is an unmapped
+ *   physical address and cannot be used until it is appropriately mapped.
+ *
+ ****************************************************************************/
+
+uintptr_t mm_pgalloc(unsigned int npages)
+{
+  return mm_pgalloc_align(npages, 1);
+}
+
+/****************************************************************************
+ * Name: mm_pgalloc_align
+ *
+ * Description:
+ *   Allocate page memory from the page memory pool.
+ *
+ * Input Parameters:
+ *   npages - The number of pages to allocate, each of size CONFIG_MM_PGSIZE.
+ *   align  - The number of pages to align, each of size CONFIG_MM_PGSIZE.
+ *
+ * Returned Value:
+ *   On success, a non-zero, physical address of the allocated page memory
+ *   is returned.  Zero is returned on failure.  NOTE:  This is an unmapped
+ *   physical address and cannot be used until it is appropriately mapped.
+ *
+ ****************************************************************************/
+
+uintptr_t mm_pgalloc_align(unsigned int npages, unsigned int align)
+{
+  unsigned int order = pgbuddy_order(npages);
+  irqstate_t flags;
+  uint32_t ndx;
+
+  /* A block is aligned to its size, so an alignment is met by a block of
+   * at least that size.  The pages beyond npages are returned at once.
+   */
+
+  if (align > 1 && pgbuddy_order(align) > order)
+    {
+      order = pgbuddy_order(align);
+    }
+
+  if (npages == 0 || order > PGBUDDY_MAXORDER)
+    {
+      pgaerr("ERROR: Cannot allocate %u pages aligned to %u\n",
+             npages, align);
+      return 0;
+    }
+
+  flags = spin_lock_irqsave(&g_pgbuddy.lock);
+  ndx   = pgbuddy_alloc(npages, order);
+  spin_unlock_irqrestore(&g_pgbuddy.lock, flags);
+
+  if (ndx == PGBUDDY_NONE)
+    {
+      pgawarn("WARNING: No block of order %u for %u pages\n",
+              order, npages);
+      return 0;
+    }
+
+  return (g_pgbuddy.pfnbase + ndx) << MM_PGSHIFT;
+}
+
+/****************************************************************************
+ * Name: mm_pgfree
+ *
+ * Description:
+ *   Return page memory to the page memory pool.
+ *
+ * Input Parameters:
+ *   paddr  - A physical address to a page in the page memory pool previously
+ *            allocated by mm_pgalloc.
+ *   npages - The number of contiguous pages to be return to the page memory
+ *            pool, beginning with the page at paddr;
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_pgfree(uintptr_t paddr, unsigned int npages)
+{
+  uintptr_t pfn = paddr >> MM_PGSHIFT;
+  irqstate_t flags;
+
+  DEBUGASSERT(MM_ISALIGNED(paddr) && pfn >= g_pgbuddy.pfnbase &&
+              pfn - g_pgbuddy.pfnbase + npages <= g_pgbuddy.npages);
+
+  flags = spin_lock_irqsave(&g_pgbuddy.lock);
+  pgbuddy_freerange(pfn - g_pgbuddy.pfnbase, npages);
+  spin_unlock_irqrestore(&g_pgbuddy.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_pginfo
+ *
+ * Description:
+ *   Return information about the page allocator.
+ *
+ * Input Parameters:
+ *   info   - Memory location to return the page allocator info.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_pginfo(FAR struct pginfo_s *info)
+{
+  irqstate_t flags;
+  int order;
+
+  DEBUGASSERT(info != NULL);
+
+  flags = spin_lock_irqsave(&g_pgbuddy.lock);
+
+  info->ntotal = g_pgbuddy.npages;
+  info->nfree  = g_pgbuddy.nfree;
+  info->mxfree = 0;
+
+  /* The largest free block, adjacent blocks are not merged here */
+
+  for (order = PGBUDDY_MAXORDER; order >= 0; order--)
+    {
+      if (g_pgbuddy.freelist[order] != PGBUDDY_NONE)
+        {
+          info->mxfree = 1 << order;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_pgbuddy.lock, flags);
+}
+
+#endif /* CONFIG_MM_PGALLOC_BUDDY */
@@ -37,6 +37,7 @@
 #include <nuttx/mm/mm.h>
 
 #include <assert.h>
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
@@ -115,6 +116,32 @@
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* With CONFIG_MM_HEAP_SEGFIT, each power-of-two class below MM_MAX_CHUNK is
+ * divided into MM_SL_COUNT free lists covering equal size ranges.  The
+ * last class holds all chunks of MM_MAX_CHUNK or more in its first list.
+ */
+
+#ifdef CONFIG_MM_HEAP_SEGFIT
+#  define MM_SL_SHIFT    3
+#  define MM_SL_COUNT    (1 << MM_SL_SHIFT)
+#endif
+
+/* The allocation latency is read from the perf counter, which is only
+ * available inside the kernel.
+ */
+
+#if defined(CONFIG_MM_HEAP_PROFILE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAP_PROFILE
+#endif
+
+/* Only the kernel heap is reclaimed, from the kernel */
+
+#if defined(CONFIG_MM_SHRINKER) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAP_SHRINKER
+#endif
+
 #define MM_GRAN_MASK     (MM_ALIGN - 1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -207,6 +234,11 @@ struct mm_freenode_s
 static_assert(MM_SIZEOF_ALLOCNODE <= MM_MIN_CHUNK,
               "Error size for struct mm_allocnode_s\n");
 
+#ifdef CONFIG_MM_HEAP_SEGFIT
+static_assert(MM_NNODES < 32 && MM_MIN_SHIFT > MM_SL_SHIFT,
+              "Error size classes for the free lists\n");
+#endif
+
 static_assert(MM_ALIGN >= sizeof(uintptr_t) &&
               (MM_ALIGN & MM_GRAN_MASK) == 0,
               "Error memory alignment\n");
@@ -245,12 +277,23 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_HEAP_SEGFIT
+  /* The free nodes are kept in unsorted, doubly linked lists segregated
+   * by size.  Bit n of mm_flbitmap is set if mm_slbitmap[n] is non-zero,
+   * and bit m of mm_slbitmap[n] is set if mm_freelist[n][m] is not empty.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_NNODES];
+  FAR struct mm_freenode_s *mm_freelist[MM_NNODES][MM_SL_COUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed up searching of free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
 
   /* Free delay list, as sometimes we can't do free immdiately. */
 
@@ -265,12 +308,19 @@ struct mm_heap_s
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   size_t                         mm_threshold;
   FAR struct mempool_multiple_s *mm_mpool;
+#  ifdef MM_HEAP_SHRINKER
+  struct mm_shrinker_s           mm_shrinker;
+#  endif
 #endif
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+  struct mm_heapprof_s mm_prof;
+#endif
+
   /* Kasan is disable or enable for this heap */
 
   bool mm_nokasan;
@@ -305,11 +355,36 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
+void mm_delayfree_list(FAR struct mm_heap_s *heap,
+                       FAR struct mm_delaynode_s *list);
 
 /* Functions contained in mm_malloc.c ***************************************/
 
 void mm_free_delaylist(FAR struct mm_heap_s *heap);
 
+/* mm_malloc_chunk() allocates from the heap itself, bypassing the sampling
+ * of KASan, for the callers which handle the returned chunk.
+ */
+
+#ifdef CONFIG_MM_KASAN_SAMPLE
+FAR void *mm_malloc_chunk(FAR struct mm_heap_s *heap, size_t size);
+#else
+#  define mm_malloc_chunk(heap, size) mm_malloc(heap, size)
+#endif
+
+/* Functions contained in mm_profile.c **************************************/
+
+#ifdef MM_HEAP_PROFILE
+void mm_profile_alloc(FAR struct mm_heap_s *heap, size_t size,
+                      clock_t start, FAR void *caller, FAR void *ret);
+#endif
+
+/* Functions contained in mm_shrink.c **************************************/
+
+#ifdef MM_HEAP_SHRINKER
+void mm_shrink_notify(FAR struct mm_heap_s *heap);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -326,6 +401,160 @@ static inline_function int mm_size2ndx(size_t size)
   return flsl(size) - 1;
 }
 
+#ifdef CONFIG_MM_HEAP_SEGFIT
+static inline_function void mm_size2list(size_t size, FAR int *fl,
+                                         FAR int *sl)
+{
+  DEBUGASSERT(size >= MM_MIN_CHUNK);
+  if (size >= MM_MAX_CHUNK)
+    {
+      *fl = MM_NNODES - 1;
+      *sl = 0;
+    }
+  else
+    {
+      *fl = flsl(size) - 1;
+      *sl = (size >> (*fl - MM_SL_SHIFT)) & (MM_SL_COUNT - 1);
+      *fl -= MM_MIN_SHIFT;
+    }
+}
+
+static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s **list;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+  int fl;
+  int sl;
+
+  DEBUGASSERT(nodesize >= MM_MIN_CHUNK);
+  DEBUGASSERT(MM_NODE_IS_FREE(node));
+
+  /* Push the node on the list of its size */
+
+  mm_size2list(nodesize, &fl, &sl);
+  list = &heap->mm_freelist[fl][sl];
+
+  node->blink = NULL;
+  node->flink = *list;
+  if (*list)
+    {
+      (*list)->blink = node;
+    }
+
+  *list = node;
+  heap->mm_slbitmap[fl] |= 1 << sl;
+  heap->mm_flbitmap     |= 1 << fl;
+}
+
+static inline_function void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  if (node->blink)
+    {
+      node->blink->flink = node->flink;
+    }
+  else
+    {
+      /* The node is the head of its list */
+
+      mm_size2list(MM_SIZEOF_NODE(node), &fl, &sl);
+      DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+
+      heap->mm_freelist[fl][sl] = node->flink;
+      if (node->flink == NULL)
+        {
+          heap->mm_slbitmap[fl] &= ~(1 << sl);
+          if (heap->mm_slbitmap[fl] == 0)
+            {
+              heap->mm_flbitmap &= ~(1 << fl);
+            }
+        }
+    }
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+}
+
+static inline_function FAR struct mm_freenode_s *
+mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  size_t roundup = size;
+  uint32_t bitmap;
+  int fl;
+  int sl;
+
+  /* Round the size up to the next list boundary, so that every chunk of
+   * the lists searched is large enough.
+   */
+
+  if (size < MM_MAX_CHUNK)
+    {
+      roundup += (1 << (flsl(size) - 1 - MM_SL_SHIFT)) - 1;
+    }
+
+  mm_size2list(roundup, &fl, &sl);
+
+  /* Find the first non-empty list at or above that one */
+
+  bitmap = heap->mm_slbitmap[fl] & (~0u << sl);
+  if (bitmap == 0)
+    {
+      bitmap = heap->mm_flbitmap & (~0u << (fl + 1));
+      if (bitmap == 0)
+        {
+          return NULL;
+        }
+
+      fl     = ffs(bitmap) - 1;
+      bitmap = heap->mm_slbitmap[fl];
+    }
+
+  sl   = ffs(bitmap) - 1;
+  node = heap->mm_freelist[fl][sl];
+
+  /* The chunks of the last class are not bounded in size */
+
+  if (fl == MM_NNODES - 1)
+    {
+      while (node && MM_SIZEOF_NODE(node) < size)
+        {
+          node = node->flink;
+        }
+    }
+
+  return node;
+}
+
+static inline_function size_t
+mm_largestfreechunk(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_freenode_s *node;
+  size_t largest = 0;
+  int fl;
+  int sl;
+
+  /* The largest chunk is in the highest non-empty list */
+
+  if (heap->mm_flbitmap != 0)
+    {
+      fl = fls(heap->mm_flbitmap) - 1;
+      sl = fls(heap->mm_slbitmap[fl]) - 1;
+      for (node = heap->mm_freelist[fl][sl]; node; node = node->flink)
+        {
+          largest = MAX(largest, MM_SIZEOF_NODE(node));
+        }
+    }
+
+  return largest;
+}
+#else
 static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
                                             FAR struct mm_freenode_s *node)
 {
@@ -362,4 +591,65 @@ static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
     }
 }
 
+static inline_function void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+  /* There must be a predecessor, but there may not be a successor node */
+
+  DEBUGASSERT(node->blink);
+  node->blink->flink = node->flink;
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+}
+
+static inline_function FAR struct mm_freenode_s *
+mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_freenode_s *node;
+
+  /* Search for a large enough chunk in the list of nodes. This list is
+   * ordered by size, but will have occasional zero sized nodes as we visit
+   * other mm_nodelist[] entries.  Since the list is ordered, the first
+   * chunk found is the best fitting chunk available.
+   */
+
+  for (node = heap->mm_nodelist[mm_size2ndx(size)].flink; node;
+       node = node->flink)
+    {
+      DEBUGASSERT(node->blink->flink == node);
+      if (MM_SIZEOF_NODE(node) >= size)
+        {
+          break;
+        }
+    }
+
+  return node;
+}
+
+static inline_function size_t
+mm_largestfreechunk(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_freenode_s *node;
+
+  /* The lists are chained in size order, so the largest chunk is the last
+   * non-sentinel node of the chain.
+   */
+
+  for (node = &heap->mm_nodelist[MM_NNODES - 1]; node->flink;
+       node = node->flink);
+
+  for (; node; node = node->blink)
+    {
+      if (node->size != 0)
+        {
+          return MM_SIZEOF_NODE(node);
+        }
+    }
+
+  return 0;
+}
+#endif
+
 #endif /* __MM_MM_HEAP_MM_H */
@@ -53,6 +53,10 @@ static void checkcorruption_handler(FAR struct mm_allocnode_s *node,
       FAR struct mm_freenode_s *fnode = (FAR void *)node;
 
       ASSERT(nodesize >= MM_MIN_CHUNK);
+#ifdef CONFIG_MM_HEAP_SEGFIT
+      ASSERT(fnode->blink == NULL || fnode->blink->flink == fnode);
+      ASSERT(fnode->flink == NULL || fnode->flink->blink == fnode);
+#else
       ASSERT(fnode->blink->flink == fnode);
       ASSERT(MM_SIZEOF_NODE(fnode->blink) <= nodesize);
       ASSERT(fnode->flink == NULL ||
@@ -60,6 +64,7 @@ static void checkcorruption_handler(FAR struct mm_allocnode_s *node,
       ASSERT(fnode->flink == NULL ||
              MM_SIZEOF_NODE(fnode->flink) == 0 ||
              MM_SIZEOF_NODE(fnode->flink) >= nodesize);
+#endif
     }
 }
 
@@ -70,60 +70,48 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: mm_delayfree
+ * Name: free_poison
  *
  * Description:
- *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *   Fill and poison the memory of a chunk being freed.  The heap must be
+ *   locked.
  *
  ****************************************************************************/
 
-void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+static void free_poison(FAR struct mm_heap_s *heap, FAR void *mem,
+                        bool fill)
 {
-  FAR struct mm_freenode_s *node;
-  FAR struct mm_freenode_s *prev;
-  FAR struct mm_freenode_s *next;
-  size_t nodesize;
-  size_t prevsize;
-
-  if (mm_lock(heap) < 0)
-    {
-      /* Meet -ESRCH return, which means we are in situations
-       * during context switching(See mm_lock() & gettid()).
-       * Then add to the delay list.
-       */
-
-      add_delaylist(heap, mem);
-      return;
-    }
+  size_t nodesize = mm_malloc_size(heap, mem);
 
-  nodesize = mm_malloc_size(heap, mem);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
-#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  /* If delay free is enabled, a memory node will be freed twice.
-   * The first time is to add the node to the delay list, and the second
-   * time is to actually free the node. Therefore, we only colorize the
-   * memory node the first time, when `delay` is set to true.
-   */
-
-  if (delay)
-#endif
+  if (fill)
     {
       memset(mem, MM_FREE_MAGIC, nodesize);
     }
+#else
+  UNUSED(fill);
 #endif
 
   kasan_poison(mem, nodesize);
+  UNUSED(nodesize);
+}
 
-  if (delay)
-    {
-      mm_unlock(heap);
-      add_delaylist(heap, mem);
-      return;
-    }
+/****************************************************************************
+ * Name: free_chunk
+ *
+ * Description:
+ *   Return a chunk to the free lists, merging it with the adjacent free
+ *   chunks.  The heap must be locked.
+ *
+ ****************************************************************************/
+
+static void free_chunk(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_freenode_s *node;
+  FAR struct mm_freenode_s *prev;
+  FAR struct mm_freenode_s *next;
+  size_t nodesize;
+  size_t prevsize;
 
   /* Map the memory chunk into a free node */
 
@@ -160,16 +148,9 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
       DEBUGASSERT(MM_PREVNODE_IS_FREE(andbeyond) &&
                   andbeyond->preceding == nextsize);
 
-      /* Remove the next node.  There must be a predecessor,
-       * but there may not be a successor node.
-       */
+      /* Remove the next node from the free list */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -195,16 +176,9 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
       prevsize = MM_SIZEOF_NODE(prev);
       DEBUGASSERT(MM_NODE_IS_FREE(prev) && node->preceding == prevsize);
 
-      /* Remove the node.  There must be a predecessor, but there may
-       * not be a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -217,6 +191,87 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   /* Add the merged node to the nodelist */
 
   mm_addfreechunk(heap, node);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_delayfree
+ *
+ * Description:
+ *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *
+ ****************************************************************************/
+
+void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+{
+  if (mm_lock(heap) < 0)
+    {
+      /* Meet -ESRCH return, which means we are in situations
+       * during context switching(See mm_lock() & gettid()).
+       * Then add to the delay list.
+       */
+
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  /* If delay free is enabled, a memory node will be freed twice.
+   * The first time is to add the node to the delay list, and the second
+   * time is to actually free the node. Therefore, we only colorize the
+   * memory node the first time, when `delay` is set to true.
+   */
+
+  free_poison(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX == 0 || delay);
+
+  if (delay)
+    {
+      mm_unlock(heap);
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  free_chunk(heap, mem);
+  mm_unlock(heap);
+}
+
+/****************************************************************************
+ * Name: mm_delayfree_list
+ *
+ * Description:
+ *   Free a list of delayed nodes, taking the heap lock only once.
+ *
+ ****************************************************************************/
+
+void mm_delayfree_list(FAR struct mm_heap_s *heap,
+                       FAR struct mm_delaynode_s *list)
+{
+  FAR struct mm_delaynode_s *next;
+
+  if (mm_lock(heap) < 0)
+    {
+      /* Put the nodes back to the delay list and retry later */
+
+      for (; list != NULL; list = next)
+        {
+          next = list->flink;
+          add_delaylist(heap, list);
+        }
+
+      return;
+    }
+
+  for (; list != NULL; list = next)
+    {
+      /* The link is overwritten once the node is freed */
+
+      next = list->flink;
+      free_poison(heap, list, CONFIG_MM_FREE_DELAYCOUNT_MAX == 0);
+      free_chunk(heap, list);
+    }
+
   mm_unlock(heap);
 }
 
@@ -242,6 +297,11 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 
   DEBUGASSERT(mm_heapmember(heap, mem));
 
+  if (kasan_sample_free(heap, mem))
+    {
+      return;
+    }
+
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   if (heap->mm_mpool)
     {
@@ -254,3 +314,70 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
+
+/****************************************************************************
+ * Name: mm_free_bulk
+ *
+ * Description:
+ *   Return a set of chunks to the heap.  Unlike calling mm_free() for each
+ *   chunk, the heap lock is taken only once for the whole set.  NULL
+ *   entries are ignored.
+ *
+ * Input Parameters:
+ *   heap  - The heap the memory was allocated from
+ *   mem   - The array of memory to free
+ *   count - The number of entries in the array
+ *
+ ****************************************************************************/
+
+void mm_free_bulk(FAR struct mm_heap_s *heap, FAR void *const *mem,
+                  size_t count)
+{
+  bool locked = false;
+  size_t i;
+
+  for (i = 0; i < count; i++)
+    {
+      if (mem[i] == NULL)
+        {
+          continue;
+        }
+
+      minfo("Freeing %p\n", mem[i]);
+      DEBUGASSERT(mm_heapmember(heap, mem[i]));
+
+      if (kasan_sample_free(heap, mem[i]))
+        {
+          continue;
+        }
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+      if (heap->mm_mpool)
+        {
+          if (mempool_multiple_free(heap->mm_mpool, mem[i]) >= 0)
+            {
+              continue;
+            }
+        }
+#endif
+
+      if (!locked)
+        {
+          if (mm_lock(heap) < 0)
+            {
+              add_delaylist(heap, mem[i]);
+              continue;
+            }
+
+          locked = true;
+        }
+
+      free_poison(heap, mem[i], true);
+      free_chunk(heap, mem[i]);
+    }
+
+  if (locked)
+    {
+      mm_unlock(heap);
+    }
+}
@@ -57,9 +57,19 @@
 
 bool mm_heapmember(FAR struct mm_heap_s *heap, FAR void *mem)
 {
-  mem = kasan_clear_tag(mem);
 #if CONFIG_MM_REGIONS > 1
   int i;
+#endif
+
+  /* Memory sampled by KASan lies outside of the heap */
+
+  if (kasan_sample_size(heap, mem) >= 0)
+    {
+      return true;
+    }
+
+  mem = kasan_clear_tag(mem);
+#if CONFIG_MM_REGIONS > 1
 
   /* A valid address from the heap for this region would have to lie
    * between the region's two guard nodes.
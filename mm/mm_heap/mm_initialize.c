@@ -78,6 +78,26 @@ static FAR void *mempool_memalign(FAR void *arg, size_t alignment,
 #  define mempool_memalign mm_memalign
 #endif
 
+#if defined(CONFIG_MM_HEAP_MEMPOOL) && defined(MM_HEAP_SHRINKER)
+
+/****************************************************************************
+ * Name: mempool_shrinker_scan
+ *
+ * Description:
+ *   Give the free expansions of the heap's mempool back to the heap.
+ ****************************************************************************/
+
+static size_t mempool_shrinker_scan(FAR struct mm_shrinker_s *shrinker,
+                                    size_t nbytes)
+{
+  FAR struct mm_heap_s *heap =
+    container_of(shrinker, struct mm_heap_s, mm_shrinker);
+
+  UNUSED(nbytes);
+  return mempool_multiple_shrink(heap->mm_mpool);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -238,7 +258,9 @@ mm_initialize_heap(FAR const struct mm_heap_config_s *config)
   FAR const char *name = config->name;
   FAR void *heapstart = config->start;
   size_t heapsize = config->size;
+#ifndef CONFIG_MM_HEAP_SEGFIT
   int i;
+#endif
 
   minfo("Heap: name=%s, start=%p size=%zu\n", name, heapstart, heapsize);
   if (heap == NULL)
@@ -271,6 +293,11 @@ mm_initialize_heap(FAR const struct mm_heap_config_s *config)
   memset(heap, 0, sizeof(struct mm_heap_s));
   heap->mm_nokasan = config->nokasan;
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+  heap->mm_prof.minlargest = SIZE_MAX;
+#endif
+
+#ifndef CONFIG_MM_HEAP_SEGFIT
   /* Initialize the node array */
 
   for (i = 1; i < MM_NNODES; i++)
@@ -278,6 +305,7 @@ mm_initialize_heap(FAR const struct mm_heap_config_s *config)
       heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
     }
+#endif
 
   /* Initialize the malloc mutex to one (to support one-at-
    * a-time access to private data sets).
@@ -359,6 +387,15 @@ mm_initialize_pool(FAR const struct mm_heap_config_s *config,
                                (mempool_multiple_free_t)mm_free, heap,
                                init->chunksize, init->expandsize,
                                init->dict_expendsize);
+#  ifdef MM_HEAP_SHRINKER
+      if (heap->mm_mpool != NULL)
+        {
+          heap->mm_shrinker.name = config->name;
+          heap->mm_shrinker.count = NULL;
+          heap->mm_shrinker.scan = mempool_shrinker_scan;
+          mm_register_shrinker(&heap->mm_shrinker);
+        }
+#  endif
     }
 
   return heap;
@@ -384,6 +421,13 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
   int i;
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
+#  ifdef MM_HEAP_SHRINKER
+  if (heap->mm_mpool != NULL)
+    {
+      mm_unregister_shrinker(&heap->mm_shrinker);
+    }
+#  endif
+
   mempool_multiple_deinit(heap->mm_mpool);
 #endif
 
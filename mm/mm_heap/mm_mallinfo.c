@@ -69,6 +69,10 @@ static void mallinfo_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
       FAR struct mm_freenode_s *fnode = (FAR void *)node;
 
       DEBUGASSERT(nodesize >= MM_MIN_CHUNK);
+#ifdef CONFIG_MM_HEAP_SEGFIT
+      DEBUGASSERT(fnode->blink == NULL || fnode->blink->flink == fnode);
+      DEBUGASSERT(fnode->flink == NULL || fnode->flink->blink == fnode);
+#else
       DEBUGASSERT(fnode->blink->flink == fnode);
       DEBUGASSERT(MM_SIZEOF_NODE(fnode->blink) <= nodesize);
       DEBUGASSERT(fnode->flink == NULL ||
@@ -76,6 +80,7 @@ static void mallinfo_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
       DEBUGASSERT(fnode->flink == NULL ||
                   MM_SIZEOF_NODE(fnode->flink) == 0 ||
                   MM_SIZEOF_NODE(fnode->flink) >= nodesize);
+#endif
 
       info->ordblks++;
       info->fordblks += nodesize;
@@ -204,19 +209,6 @@ size_t mm_heapfree(FAR struct mm_heap_s *heap)
 
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 {
-  FAR struct mm_freenode_s *node;
-
   mm_free_delaylist(heap);
-
-  for (node = heap->mm_nodelist[MM_NNODES - 1].blink; node;
-       node = node->blink)
-    {
-      size_t nodesize = MM_SIZEOF_NODE(node);
-      if (nodesize != 0)
-        {
-          return nodesize;
-        }
-    }
-
-  return 0;
+  return mm_largestfreechunk(heap);
 }
@@ -31,6 +31,7 @@
 #include <string.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/mm/kasan.h>
 #include <nuttx/sched.h>
@@ -89,20 +90,11 @@ static bool free_delaylist(FAR struct mm_heap_s *heap, bool force)
 
   ret = tmp != NULL;
 
-  while (tmp)
-    {
-      FAR void *address;
-
-      /* Get the first delayed deallocation */
+  /* Free the whole list at once rather than taking the lock per node */
 
-      address = tmp;
-      tmp = tmp->flink;
-
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
-       */
-
-      mm_delayfree(heap, address, false);
+  if (ret)
+    {
+      mm_delayfree_list(heap, tmp);
     }
 
 #endif
@@ -167,13 +159,19 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_KASAN_SAMPLE
+FAR void *mm_malloc_chunk(FAR struct mm_heap_s *heap, size_t size)
+#else
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+#endif
 {
   FAR struct mm_freenode_s *node;
   size_t alignsize;
   size_t nodesize;
   FAR void *ret = NULL;
-  int ndx;
+#ifdef MM_HEAP_PROFILE
+  clock_t start;
+#endif
 
   /* Free the delay list first */
 
@@ -210,33 +208,19 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGASSERT(alignsize >= MM_ALIGN);
 
+#ifdef MM_HEAP_PROFILE
+  start = perf_gettime();
+#endif
+
   /* We need to hold the MM mutex while we muck with the nodelist. */
 
   DEBUGVERIFY(mm_lock(heap));
 
-  /* Convert the request size into a nodelist index */
-
-  ndx = mm_size2ndx(alignsize);
+  /* Search for a large enough chunk in the free lists */
 
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
-   */
+  node = mm_findfreechunk(heap, alignsize);
 
-  for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink)
-    {
-      DEBUGASSERT(node->blink->flink == node);
-      nodesize = MM_SIZEOF_NODE(node);
-      if (nodesize >= alignsize)
-        {
-          break;
-        }
-    }
-
-  /* If we found a node with non-zero size, then this is one to use. Since
-   * the list is ordered, we know that it must be the best fitting chunk
-   * available.
-   */
+  /* If we found a node, then this is one to use */
 
   if (node)
     {
@@ -244,16 +228,10 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      nodesize = MM_SIZEOF_NODE(node);
+      mm_delfreechunk(heap, node);
 
       /* Get a pointer to the next node in physical memory */
 
@@ -328,6 +306,10 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
                       heap->mm_curused);
     }
 
+#ifdef MM_HEAP_PROFILE
+  mm_profile_alloc(heap, alignsize, start, return_address(0), ret);
+#endif
+
   mm_unlock(heap);
 
   if (ret)
@@ -339,6 +321,12 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 #endif
 #ifdef CONFIG_DEBUG_MM
       minfo("Allocated %p, size %zu\n", ret, alignsize);
+#endif
+#ifdef MM_HEAP_SHRINKER
+      if (heap == KRN_HEAP)
+        {
+          mm_shrink_notify(heap);
+        }
 #endif
     }
 
@@ -347,7 +335,16 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   else if (free_delaylist(heap, true))
     {
-      return mm_malloc(heap, size);
+      return mm_malloc_chunk(heap, size);
+    }
+#endif
+
+#ifdef MM_HEAP_SHRINKER
+  /* Try again after the shrinkers released memory */
+
+  else if (heap == KRN_HEAP && mm_shrink(alignsize) > 0)
+    {
+      return mm_malloc_chunk(heap, size);
     }
 #endif
 
@@ -411,3 +408,26 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % MM_ALIGN == 0);
   return ret;
 }
+
+#ifdef CONFIG_MM_KASAN_SAMPLE
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *   Let KASan take one in CONFIG_MM_KASAN_SAMPLE_INTERVAL allocations into
+ *   its guarded pool, allocate the others from the heap.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR void *ret = kasan_sample_alloc(heap, size);
+
+  if (ret != NULL)
+    {
+      return ret;
+    }
+
+  return mm_malloc_chunk(heap, size);
+}
+#endif
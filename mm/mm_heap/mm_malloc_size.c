@@ -44,6 +44,12 @@ size_t mm_malloc_size(FAR struct mm_heap_s *heap, FAR void *mem)
   ssize_t size;
   bool flag;
 
+  size = kasan_sample_size(heap, mem);
+  if (size >= 0)
+    {
+      return size;
+    }
+
   flag = kasan_bypass(true);
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   if (heap->mm_mpool)
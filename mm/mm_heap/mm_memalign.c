@@ -131,9 +131,11 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       return NULL;
     }
 
-  /* Then malloc that size */
+  /* Then malloc that size, this also accounts the allocation in the heap
+   * profile.
+   */
 
-  rawchunk = (uintptr_t)mm_malloc(heap, allocsize);
+  rawchunk = (uintptr_t)mm_malloc_chunk(heap, allocsize);
   if (rawchunk == 0)
     {
       return NULL;
@@ -209,16 +211,9 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
           FAR struct mm_freenode_s *prev =
             (FAR struct mm_freenode_s *)((FAR char *)node - node->preceding);
 
-          /* Remove the node.  There must be a predecessor, but there may
-           * not be a successor node.
-           */
+          /* Remove the node from the free list */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           precedingsize += MM_SIZEOF_NODE(prev);
           node = (FAR struct mm_allocnode_s *)prev;
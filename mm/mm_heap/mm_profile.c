@@ -0,0 +1,212 @@
+/****************************************************************************
+ * mm/mm_heap/mm_profile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <strings.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/sched_note.h>
+
+#include "mm_heap/mm.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_prof_sizeclass
+ *
+ * Description:
+ *   Return the size class of a chunk: class n holds the sizes in
+ *   [2^n, 2^(n+1)) and the last class everything larger.
+ *
+ ****************************************************************************/
+
+static int mm_prof_sizeclass(size_t size)
+{
+  int ndx = flsl(size) - 1;
+
+  return ndx < MM_PROF_NSIZES ? ndx : MM_PROF_NSIZES - 1;
+}
+
+/****************************************************************************
+ * Name: mm_prof_fragmentation
+ *
+ * Description:
+ *   Return the fragmentation index of the free memory in permille, that is
+ *   the share of the free memory that is not part of the largest chunk.
+ *
+ ****************************************************************************/
+
+static long mm_prof_fragmentation(size_t freesize, size_t largest)
+{
+  if (freesize == 0 || largest >= freesize)
+    {
+      return 0;
+    }
+
+  return (long)(1000 - (uint64_t)largest * 1000 / freesize);
+}
+
+/****************************************************************************
+ * Name: mm_prof_freehandler
+ ****************************************************************************/
+
+static void mm_prof_freehandler(FAR struct mm_allocnode_s *node,
+                                FAR void *arg)
+{
+  FAR struct mm_heapprof_s *prof = arg;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+
+  if (MM_NODE_IS_FREE(node))
+    {
+      prof->nfree[mm_prof_sizeclass(nodesize)]++;
+      prof->freesize += nodesize;
+      if (nodesize > prof->largest)
+        {
+          prof->largest = nodesize;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_alloc
+ *
+ * Description:
+ *   Account one allocation attempt of a chunk of 'size' bytes which
+ *   started at perf time 'start'.  The heap must be locked by the caller.
+ *
+ * Input Parameters:
+ *   heap   - The heap the chunk was allocated from
+ *   size   - The size of the chunk, including the chunk header
+ *   start  - The perf time at the start of the allocation
+ *   caller - The address the allocation was called from
+ *   ret    - The allocated memory, NULL if the allocation failed
+ *
+ ****************************************************************************/
+
+void mm_profile_alloc(FAR struct mm_heap_s *heap, size_t size,
+                      clock_t start, FAR void *caller, FAR void *ret)
+{
+  FAR struct mm_heapprof_s *prof = &heap->mm_prof;
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+  struct note_counter_s counter;
+#endif
+  struct timespec ts;
+  unsigned long latency;
+  int ndx;
+
+  perf_convert(perf_gettime() - start, &ts);
+  latency = ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+
+  if (ret == NULL)
+    {
+      prof->nfailed++;
+    }
+  else
+    {
+      prof->nalloc[mm_prof_sizeclass(size)]++;
+    }
+
+  ndx = latency != 0 ? flsl(latency) : 0;
+  prof->latency[ndx < MM_PROF_NLATENCY ? ndx : MM_PROF_NLATENCY - 1]++;
+  if (latency > prof->maxlatency)
+    {
+      prof->maxlatency = latency;
+    }
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+  /* Attribute the latency to the call site rather than to this function */
+
+  counter.value = latency;
+  strlcpy(counter.name, "mm_latency", NAME_MAX);
+  sched_note_event_ip(NOTE_TAG_MM, (uintptr_t)caller, NOTE_DUMP_COUNTER,
+                      &counter, sizeof(counter));
+#else
+  UNUSED(caller);
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_heapprof
+ *
+ * Description:
+ *   Return the allocation profile of the heap together with a snapshot of
+ *   its free chunks.  The largest free chunk is only looked up here, so
+ *   the low watermark of it covers the snapshots taken so far rather than
+ *   every single allocation.
+ *
+ ****************************************************************************/
+
+void mm_heapprof(FAR struct mm_heap_s *heap, FAR struct mm_heapprof_s *prof)
+{
+  DEBUGASSERT(prof != NULL);
+
+  if (mm_lock(heap) < 0)
+    {
+      memset(prof, 0, sizeof(*prof));
+      return;
+    }
+
+  memcpy(prof, &heap->mm_prof, sizeof(*prof));
+  mm_unlock(heap);
+
+  /* The free chunks are counted region by region by mm_foreach() */
+
+  memset(prof->nfree, 0, sizeof(prof->nfree));
+  prof->freesize = 0;
+  prof->largest  = 0;
+
+  mm_foreach(heap, mm_prof_freehandler, prof);
+
+  if (mm_lock(heap) >= 0)
+    {
+      heap->mm_prof.largest = prof->largest;
+      if (heap->mm_prof.minlargest > prof->largest)
+        {
+          heap->mm_prof.minlargest = prof->largest;
+        }
+
+      mm_unlock(heap);
+    }
+
+  if (prof->minlargest > prof->largest)
+    {
+      prof->minlargest = prof->largest;
+    }
+
+  sched_note_counter(NOTE_TAG_MM, "mm_largest", prof->largest);
+  sched_note_counter(NOTE_TAG_MM, "mm_frag",
+                     mm_prof_fragmentation(prof->freesize, prof->largest));
+}
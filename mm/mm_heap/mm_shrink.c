@@ -0,0 +1,264 @@
+/****************************************************************************
+ * mm/mm_heap/mm_shrink.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/debug.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef MM_HEAP_SHRINKER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MM_SHRINKER_THRESHOLD
+#  define CONFIG_MM_SHRINKER_THRESHOLD 0
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The registered shrinkers, the lock also serializes the reclaim */
+
+static struct list_node g_mm_shrinkers = LIST_INITIAL_VALUE(g_mm_shrinkers);
+static mutex_t g_mm_shrinklock = NXMUTEX_INITIALIZER;
+
+/* Free memory of the kernel heap below which the reclaim runs */
+
+static size_t g_mm_shrinkthreshold = CONFIG_MM_SHRINKER_THRESHOLD;
+
+#ifdef CONFIG_SCHED_LPWORK
+static struct work_s g_mm_shrinkwork;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_shrink_worker
+ *
+ * Description:
+ *   Run the shrinkers until the free memory of the heap is above the
+ *   threshold again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+static void mm_shrink_worker(FAR void *arg)
+{
+  FAR struct mm_heap_s *heap = arg;
+  size_t threshold = g_mm_shrinkthreshold;
+  size_t nfree = mm_heapfree(heap);
+
+  if (nfree < threshold)
+    {
+      mm_shrink(threshold - nfree);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_register_shrinker
+ *
+ * Description:
+ *   Register a shrinker, which is asked to release memory when the kernel
+ *   heap runs low.  The shrinker must stay valid until it is unregistered.
+ *
+ ****************************************************************************/
+
+void mm_register_shrinker(FAR struct mm_shrinker_s *shrinker)
+{
+  DEBUGASSERT(shrinker != NULL && shrinker->scan != NULL);
+
+  nxmutex_lock(&g_mm_shrinklock);
+  list_add_tail(&g_mm_shrinkers, &shrinker->node);
+  nxmutex_unlock(&g_mm_shrinklock);
+}
+
+/****************************************************************************
+ * Name: mm_unregister_shrinker
+ *
+ * Description:
+ *   Unregister a shrinker, waiting for a reclaim that may be running it.
+ *
+ ****************************************************************************/
+
+void mm_unregister_shrinker(FAR struct mm_shrinker_s *shrinker)
+{
+  nxmutex_lock(&g_mm_shrinklock);
+  list_delete(&shrinker->node);
+  nxmutex_unlock(&g_mm_shrinklock);
+}
+
+/****************************************************************************
+ * Name: mm_shrink
+ *
+ * Description:
+ *   Ask the shrinkers, in the order they were registered, to release
+ *   memory until 'nbytes' bytes have been released.
+ *
+ * Input Parameters:
+ *   nbytes - The number of bytes to release, SIZE_MAX releases all that
+ *            the shrinkers can release.
+ *
+ * Returned Value:
+ *   The number of bytes released.  Zero is returned from an interrupt
+ *   handler and when called from a shrinker.
+ *
+ ****************************************************************************/
+
+size_t mm_shrink(size_t nbytes)
+{
+  FAR struct mm_shrinker_s *shrinker;
+  size_t released = 0;
+
+  /* The shrinkers may block, and an allocation failing inside of one must
+   * not run them again.
+   */
+
+  if (up_interrupt_context() || _SCHED_GETTID() < 0 ||
+      nxmutex_is_hold(&g_mm_shrinklock) ||
+      nxmutex_lock(&g_mm_shrinklock) < 0)
+    {
+      return 0;
+    }
+
+  list_for_every_entry(&g_mm_shrinkers, shrinker,
+                       struct mm_shrinker_s, node)
+    {
+      if (shrinker->count != NULL && shrinker->count(shrinker) == 0)
+        {
+          continue;
+        }
+
+      released += shrinker->scan(shrinker, nbytes - released);
+      if (released >= nbytes)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_mm_shrinklock);
+
+  minfo("Released %zu of %zu bytes\n", released, nbytes);
+  return released;
+}
+
+/****************************************************************************
+ * Name: mm_shrink_setthreshold
+ *
+ * Description:
+ *   Set the free memory of the kernel heap below which the shrinkers are
+ *   run in the background, zero only runs them when an allocation fails.
+ *
+ ****************************************************************************/
+
+void mm_shrink_setthreshold(size_t threshold)
+{
+  g_mm_shrinkthreshold = threshold;
+}
+
+/****************************************************************************
+ * Name: mm_shrink_getthreshold
+ *
+ * Description:
+ *   Return the background reclaim threshold.
+ *
+ ****************************************************************************/
+
+size_t mm_shrink_getthreshold(void)
+{
+  return g_mm_shrinkthreshold;
+}
+
+/****************************************************************************
+ * Name: mm_shrink_foreach
+ *
+ * Description:
+ *   Call 'handler' for every registered shrinker.
+ *
+ ****************************************************************************/
+
+void mm_shrink_foreach(mm_shrinker_handler_t handler, FAR void *arg)
+{
+  FAR struct mm_shrinker_s *shrinker;
+
+  if (nxmutex_lock(&g_mm_shrinklock) < 0)
+    {
+      return;
+    }
+
+  list_for_every_entry(&g_mm_shrinkers, shrinker,
+                       struct mm_shrinker_s, node)
+    {
+      handler(shrinker, arg);
+    }
+
+  nxmutex_unlock(&g_mm_shrinklock);
+}
+
+/****************************************************************************
+ * Name: mm_shrink_notify
+ *
+ * Description:
+ *   Start the background reclaim if the free memory of the heap dropped
+ *   below the threshold.  Called after each allocation from the kernel
+ *   heap.
+ *
+ ****************************************************************************/
+
+void mm_shrink_notify(FAR struct mm_heap_s *heap)
+{
+#ifdef CONFIG_SCHED_LPWORK
+  size_t threshold = g_mm_shrinkthreshold;
+
+  if (threshold != 0 && heap->mm_heapsize - heap->mm_curused < threshold &&
+      work_available(&g_mm_shrinkwork))
+    {
+      work_queue(LPWORK, &g_mm_shrinkwork, mm_shrink_worker, heap, 0);
+    }
+#else
+  UNUSED(heap);
+#endif
+}
+
+#endif /* MM_HEAP_SHRINKER */
@@ -942,6 +942,25 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
 
+/****************************************************************************
+ * Name: mm_free_bulk
+ *
+ * Description:
+ *   Return a set of chunks to the heap.  NULL entries are ignored.
+ *
+ ****************************************************************************/
+
+void mm_free_bulk(FAR struct mm_heap_s *heap, FAR void *const *mem,
+                  size_t count)
+{
+  size_t i;
+
+  for (i = 0; i < count; i++)
+    {
+      mm_free(heap, mem[i]);
+    }
+}
+
 /****************************************************************************
  * Name: mm_heapmember
  *
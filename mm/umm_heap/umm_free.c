@@ -50,3 +50,17 @@ void free(FAR void *mem)
 {
   mm_free(USR_HEAP, mem);
 }
+
+/****************************************************************************
+ * Name: umm_free_bulk
+ *
+ * Description:
+ *   Returns a set of chunks of user memory to the heap, taking the heap
+ *   lock only once.  NULL entries are ignored.
+ *
+ ****************************************************************************/
+
+void umm_free_bulk(FAR void *const *mem, size_t count)
+{
+  mm_free_bulk(USR_HEAP, mem, count);
+}
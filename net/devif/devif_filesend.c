@@ -107,7 +107,7 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
 
   while (remain > 0)
     {
-      if (iob->io_len + iob->io_offset == CONFIG_IOB_BUFSIZE)
+      if (IOB_FREESPACE(iob) == 0)
         {
           if (iob->io_flink == NULL)
             {
@@ -122,8 +122,7 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
           iob = iob->io_flink;
         }
 
-      copying = CONFIG_IOB_BUFSIZE -
-                (iob->io_len + iob->io_offset);
+      copying = IOB_FREESPACE(iob);
       if (copying > remain)
         {
           copying = remain;
@@ -74,7 +74,7 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  if (len > NETDEV_GSO_MAXLEN(dev) - target_offset)
     {
       ret = -EMSGSIZE;
       goto errout;
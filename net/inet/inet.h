@@ -297,6 +297,22 @@ uint16_t ipv4_build_header(FAR struct ipv4_hdr_s *ipv4, uint16_t total_len,
                            uint8_t tos, FAR struct ipv4_opt_s *opt);
 #endif
 
+/****************************************************************************
+ * Name: ipv4_reserve_ipid
+ *
+ * Description:
+ *   Skip IP identifications used by the device for the segments of the
+ *   last packet built, when it splits that packet (NETDEV_TX_GSO).
+ *
+ * Input Parameters:
+ *   count      The number of identifications to skip
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void ipv4_reserve_ipid(uint16_t count);
+#endif
+
 /****************************************************************************
  * Name: ipv6_build_header
  *
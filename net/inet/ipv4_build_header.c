@@ -112,4 +112,21 @@ uint16_t ipv4_build_header(FAR struct ipv4_hdr_s *ipv4, uint16_t total_len,
   return (ipv4->vhl & IPv4_HLMASK) << 2;
 }
 
+/****************************************************************************
+ * Name: ipv4_reserve_ipid
+ *
+ * Description:
+ *   Skip IP identifications used by the device for the segments of the
+ *   last packet built, when it splits that packet (NETDEV_TX_GSO).
+ *
+ * Input Parameters:
+ *   count      The number of identifications to skip
+ *
+ ****************************************************************************/
+
+void ipv4_reserve_ipid(uint16_t count)
+{
+  g_ipid += count;
+}
+
 #endif /* CONFIG_NET_IPv4 */
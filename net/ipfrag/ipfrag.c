@@ -89,8 +89,7 @@ do  \
 
 /* Helper macro to count I/O buffer count for a given I/O buffer chain */
 
-#define IOBUF_CNT(ptr)    (((ptr)->io_pktlen + CONFIG_IOB_BUFSIZE - 1)/ \
-                          CONFIG_IOB_BUFSIZE)
+#define IOBUF_CNT(ptr)    iob_count(ptr)
 
 /* The maximum I/O buffer occupied by fragment reassembly cache */
 
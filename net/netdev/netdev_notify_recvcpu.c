@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 #include <nuttx/debug.h>
 
 #include "netdev/netdev.h"
@@ -34,7 +35,6 @@
  ****************************************************************************/
 
 #define PACKET_BYTE_SIZE        36
-#define RANDOM_KEY_SIZE         40
 
 /****************************************************************************
  * Private Types
@@ -53,25 +53,215 @@ typedef enum hashcal_type_e
   HASHCAL_TYPE_2TUPLE,
 } hashcal_type_e;
 
-typedef union toeplitz_key_u
-{
-  uint8_t u8[RANDOM_KEY_SIZE];
-  uint32_t u32[10];
-} toeplitz_key_u;
-
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static const toeplitz_key_u g_random_key =
+/* The Toeplitz hash of every nibble value at every nibble position of the
+ * input, with the 40 byte key used by RSS hardware:
+ *
+ *   6d 5a 56 da 25 5b 0e c2 41 67 25 3d 43 a3 8f b0 d0 ca 2b cb
+ *   ae 7b 30 b4 77 cb 2d a3 80 30 f2 0c 6a 42 b7 3b be ac 01 fa
+ *
+ * Entry 16 * n + v is the hash of nibble v at nibble n, n = 0 being the
+ * high nibble of the first byte.  The hash of an input is the XOR of the
+ * entries of its nibbles.
+ */
+
+static const uint32_t g_toeplitz_table[2 * PACKET_BYTE_SIZE * 16] =
 {
-  .u8 =
-  {
-    0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2, 0x41, 0x67,
-    0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0, 0xd0, 0xca, 0x2b, 0xcb,
-    0xae, 0x7b, 0x30, 0xb4, 0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30,
-    0xf2, 0x0c, 0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
-  }
+  0x00000000, 0x6ad2b6d1, 0xb5695b68, 0xdfbbedb9, 0xdab4adb4, 0xb0661b65,
+  0x6fddf6dc, 0x050f400d, 0x6d5a56da, 0x0788e00b, 0xd8330db2, 0xb2e1bb63,
+  0xb7eefb6e, 0xdd3c4dbf, 0x0287a006, 0x685516d7, 0x00000000, 0xad2b6d12,
+  0x5695b689, 0xfbbedb9b, 0xab4adb44, 0x0661b656, 0xfddf6dcd, 0x50f400df,
+  0xd5a56da2, 0x788e00b0, 0x8330db2b, 0x2e1bb639, 0x7eefb6e6, 0xd3c4dbf4,
+  0x287a006f, 0x85516d7d, 0x00000000, 0xd2b6d12a, 0x695b6895, 0xbbedb9bf,
+  0xb4adb44a, 0x661b6560, 0xddf6dcdf, 0x0f400df5, 0x5a56da25, 0x88e00b0f,
+  0x330db2b0, 0xe1bb639a, 0xeefb6e6f, 0x3c4dbf45, 0x87a006fa, 0x5516d7d0,
+  0x00000000, 0x2b6d12ad, 0x95b68956, 0xbedb9bfb, 0x4adb44ab, 0x61b65606,
+  0xdf6dcdfd, 0xf400df50, 0xa56da255, 0x8e00b0f8, 0x30db2b03, 0x1bb639ae,
+  0xefb6e6fe, 0xc4dbf453, 0x7a006fa8, 0x516d7d05, 0x00000000, 0xb6d12ad8,
+  0x5b68956c, 0xedb9bfb4, 0xadb44ab6, 0x1b65606e, 0xf6dcdfda, 0x400df502,
+  0x56da255b, 0xe00b0f83, 0x0db2b037, 0xbb639aef, 0xfb6e6fed, 0x4dbf4535,
+  0xa006fa81, 0x16d7d059, 0x00000000, 0x6d12ad87, 0xb68956c3, 0xdb9bfb44,
+  0xdb44ab61, 0xb65606e6, 0x6dcdfda2, 0x00df5025, 0x6da255b0, 0x00b0f837,
+  0xdb2b0373, 0xb639aef4, 0xb6e6fed1, 0xdbf45356, 0x006fa812, 0x6d7d0595,
+  0x00000000, 0xd12ad876, 0x68956c3b, 0xb9bfb44d, 0xb44ab61d, 0x65606e6b,
+  0xdcdfda26, 0x0df50250, 0xda255b0e, 0x0b0f8378, 0xb2b03735, 0x639aef43,
+  0x6e6fed13, 0xbf453565, 0x06fa8128, 0xd7d0595e, 0x00000000, 0x12ad8761,
+  0x8956c3b0, 0x9bfb44d1, 0x44ab61d8, 0x5606e6b9, 0xcdfda268, 0xdf502509,
+  0xa255b0ec, 0xb0f8378d, 0x2b03735c, 0x39aef43d, 0xe6fed134, 0xf4535655,
+  0x6fa81284, 0x7d0595e5, 0x00000000, 0x2ad87612, 0x956c3b09, 0xbfb44d1b,
+  0x4ab61d84, 0x606e6b96, 0xdfda268d, 0xf502509f, 0x255b0ec2, 0x0f8378d0,
+  0xb03735cb, 0x9aef43d9, 0x6fed1346, 0x45356554, 0xfa81284f, 0xd0595e5d,
+  0x00000000, 0xad876120, 0x56c3b090, 0xfb44d1b0, 0xab61d848, 0x06e6b968,
+  0xfda268d8, 0x502509f8, 0x55b0ec24, 0xf8378d04, 0x03735cb4, 0xaef43d94,
+  0xfed1346c, 0x5356554c, 0xa81284fc, 0x0595e5dc, 0x00000000, 0xd876120b,
+  0x6c3b0905, 0xb44d1b0e, 0xb61d8482, 0x6e6b9689, 0xda268d87, 0x02509f8c,
+  0x5b0ec241, 0x8378d04a, 0x3735cb44, 0xef43d94f, 0xed1346c3, 0x356554c8,
+  0x81284fc6, 0x595e5dcd, 0x00000000, 0x876120b3, 0xc3b09059, 0x44d1b0ea,
+  0x61d8482c, 0xe6b9689f, 0xa268d875, 0x2509f8c6, 0xb0ec2416, 0x378d04a5,
+  0x735cb44f, 0xf43d94fc, 0xd1346c3a, 0x56554c89, 0x1284fc63, 0x95e5dcd0,
+  0x00000000, 0x76120b39, 0x3b09059c, 0x4d1b0ea5, 0x1d8482ce, 0x6b9689f7,
+  0x268d8752, 0x509f8c6b, 0x0ec24167, 0x78d04a5e, 0x35cb44fb, 0x43d94fc2,
+  0x1346c3a9, 0x6554c890, 0x284fc635, 0x5e5dcd0c, 0x00000000, 0x6120b392,
+  0xb09059c9, 0xd1b0ea5b, 0xd8482ce4, 0xb9689f76, 0x68d8752d, 0x09f8c6bf,
+  0xec241672, 0x8d04a5e0, 0x5cb44fbb, 0x3d94fc29, 0x346c3a96, 0x554c8904,
+  0x84fc635f, 0xe5dcd0cd, 0x00000000, 0x120b3929, 0x09059c94, 0x1b0ea5bd,
+  0x8482ce4a, 0x9689f763, 0x8d8752de, 0x9f8c6bf7, 0xc2416725, 0xd04a5e0c,
+  0xcb44fbb1, 0xd94fc298, 0x46c3a96f, 0x54c89046, 0x4fc635fb, 0x5dcd0cd2,
+  0x00000000, 0x20b3929e, 0x9059c94f, 0xb0ea5bd1, 0x482ce4a7, 0x689f7639,
+  0xd8752de8, 0xf8c6bf76, 0x24167253, 0x04a5e0cd, 0xb44fbb1c, 0x94fc2982,
+  0x6c3a96f4, 0x4c89046a, 0xfc635fbb, 0xdcd0cd25, 0x00000000, 0x0b3929ea,
+  0x059c94f5, 0x0ea5bd1f, 0x82ce4a7a, 0x89f76390, 0x8752de8f, 0x8c6bf765,
+  0x4167253d, 0x4a5e0cd7, 0x44fbb1c8, 0x4fc29822, 0xc3a96f47, 0xc89046ad,
+  0xc635fbb2, 0xcd0cd258, 0x00000000, 0xb3929ea1, 0x59c94f50, 0xea5bd1f1,
+  0x2ce4a7a8, 0x9f763909, 0x752de8f8, 0xc6bf7659, 0x167253d4, 0xa5e0cd75,
+  0x4fbb1c84, 0xfc298225, 0x3a96f47c, 0x89046add, 0x635fbb2c, 0xd0cd258d,
+  0x00000000, 0x3929ea1d, 0x9c94f50e, 0xa5bd1f13, 0xce4a7a87, 0xf763909a,
+  0x52de8f89, 0x6bf76594, 0x67253d43, 0x5e0cd75e, 0xfbb1c84d, 0xc2982250,
+  0xa96f47c4, 0x9046add9, 0x35fbb2ca, 0x0cd258d7, 0x00000000, 0x929ea1d1,
+  0xc94f50e8, 0x5bd1f139, 0xe4a7a874, 0x763909a5, 0x2de8f89c, 0xbf76594d,
+  0x7253d43a, 0xe0cd75eb, 0xbb1c84d2, 0x29822503, 0x96f47c4e, 0x046add9f,
+  0x5fbb2ca6, 0xcd258d77, 0x00000000, 0x29ea1d1c, 0x94f50e8e, 0xbd1f1392,
+  0x4a7a8747, 0x63909a5b, 0xde8f89c9, 0xf76594d5, 0x253d43a3, 0x0cd75ebf,
+  0xb1c84d2d, 0x98225031, 0x6f47c4e4, 0x46add9f8, 0xfbb2ca6a, 0xd258d776,
+  0x00000000, 0x9ea1d1c7, 0x4f50e8e3, 0xd1f13924, 0xa7a87471, 0x3909a5b6,
+  0xe8f89c92, 0x76594d55, 0x53d43a38, 0xcd75ebff, 0x1c84d2db, 0x8225031c,
+  0xf47c4e49, 0x6add9f8e, 0xbb2ca6aa, 0x258d776d, 0x00000000, 0xea1d1c7d,
+  0xf50e8e3e, 0x1f139243, 0x7a87471f, 0x909a5b62, 0x8f89c921, 0x6594d55c,
+  0x3d43a38f, 0xd75ebff2, 0xc84d2db1, 0x225031cc, 0x47c4e490, 0xadd9f8ed,
+  0xb2ca6aae, 0x58d776d3, 0x00000000, 0xa1d1c7d8, 0x50e8e3ec, 0xf1392434,
+  0xa87471f6, 0x09a5b62e, 0xf89c921a, 0x594d55c2, 0xd43a38fb, 0x75ebff23,
+  0x84d2db17, 0x25031ccf, 0x7c4e490d, 0xdd9f8ed5, 0x2ca6aae1, 0x8d776d39,
+  0x00000000, 0x1d1c7d86, 0x0e8e3ec3, 0x13924345, 0x87471f61, 0x9a5b62e7,
+  0x89c921a2, 0x94d55c24, 0x43a38fb0, 0x5ebff236, 0x4d2db173, 0x5031ccf5,
+  0xc4e490d1, 0xd9f8ed57, 0xca6aae12, 0xd776d394, 0x00000000, 0xd1c7d868,
+  0xe8e3ec34, 0x3924345c, 0x7471f61a, 0xa5b62e72, 0x9c921a2e, 0x4d55c246,
+  0x3a38fb0d, 0xebff2365, 0xd2db1739, 0x031ccf51, 0x4e490d17, 0x9f8ed57f,
+  0xa6aae123, 0x776d394b, 0x00000000, 0x1c7d8686, 0x8e3ec343, 0x924345c5,
+  0x471f61a1, 0x5b62e727, 0xc921a2e2, 0xd55c2464, 0xa38fb0d0, 0xbff23656,
+  0x2db17393, 0x31ccf515, 0xe490d171, 0xf8ed57f7, 0x6aae1232, 0x76d394b4,
+  0x00000000, 0xc7d86865, 0xe3ec3432, 0x24345c57, 0x71f61a19, 0xb62e727c,
+  0x921a2e2b, 0x55c2464e, 0x38fb0d0c, 0xff236569, 0xdb17393e, 0x1ccf515b,
+  0x490d1715, 0x8ed57f70, 0xaae12327, 0x6d394b42, 0x00000000, 0x7d868651,
+  0x3ec34328, 0x4345c579, 0x1f61a194, 0x62e727c5, 0x21a2e2bc, 0x5c2464ed,
+  0x8fb0d0ca, 0xf236569b, 0xb17393e2, 0xccf515b3, 0x90d1715e, 0xed57f70f,
+  0xae123276, 0xd394b427, 0x00000000, 0xd8686515, 0xec34328a, 0x345c579f,
+  0xf61a1945, 0x2e727c50, 0x1a2e2bcf, 0xc2464eda, 0xfb0d0ca2, 0x236569b7,
+  0x17393e28, 0xcf515b3d, 0x0d1715e7, 0xd57f70f2, 0xe123276d, 0x394b4278,
+  0x00000000, 0x8686515e, 0xc34328af, 0x45c579f1, 0x61a19457, 0xe727c509,
+  0xa2e2bcf8, 0x2464eda6, 0xb0d0ca2b, 0x36569b75, 0x7393e284, 0xf515b3da,
+  0xd1715e7c, 0x57f70f22, 0x123276d3, 0x94b4278d, 0x00000000, 0x686515e5,
+  0x34328af2, 0x5c579f17, 0x1a194579, 0x727c509c, 0x2e2bcf8b, 0x464eda6e,
+  0x0d0ca2bc, 0x6569b759, 0x393e284e, 0x515b3dab, 0x1715e7c5, 0x7f70f220,
+  0x23276d37, 0x4b4278d2, 0x00000000, 0x86515e5d, 0x4328af2e, 0xc579f173,
+  0xa1945797, 0x27c509ca, 0xe2bcf8b9, 0x64eda6e4, 0xd0ca2bcb, 0x569b7596,
+  0x93e284e5, 0x15b3dab8, 0x715e7c5c, 0xf70f2201, 0x3276d372, 0xb4278d2f,
+  0x00000000, 0x6515e5d7, 0x328af2eb, 0x579f173c, 0x19457975, 0x7c509ca2,
+  0x2bcf8b9e, 0x4eda6e49, 0x0ca2bcba, 0x69b7596d, 0x3e284e51, 0x5b3dab86,
+  0x15e7c5cf, 0x70f22018, 0x276d3724, 0x4278d2f3, 0x00000000, 0x515e5d73,
+  0x28af2eb9, 0x79f173ca, 0x9457975c, 0xc509ca2f, 0xbcf8b9e5, 0xeda6e496,
+  0xca2bcbae, 0x9b7596dd, 0xe284e517, 0xb3dab864, 0x5e7c5cf2, 0x0f220181,
+  0x76d3724b, 0x278d2f38, 0x00000000, 0x15e5d73d, 0x8af2eb9e, 0x9f173ca3,
+  0x457975cf, 0x509ca2f2, 0xcf8b9e51, 0xda6e496c, 0xa2bcbae7, 0xb7596dda,
+  0x284e5179, 0x3dab8644, 0xe7c5cf28, 0xf2201815, 0x6d3724b6, 0x78d2f38b,
+  0x00000000, 0x5e5d73d9, 0xaf2eb9ec, 0xf173ca35, 0x57975cf6, 0x09ca2f2f,
+  0xf8b9e51a, 0xa6e496c3, 0x2bcbae7b, 0x7596dda2, 0x84e51797, 0xdab8644e,
+  0x7c5cf28d, 0x22018154, 0xd3724b61, 0x8d2f38b8, 0x00000000, 0xe5d73d98,
+  0xf2eb9ecc, 0x173ca354, 0x7975cf66, 0x9ca2f2fe, 0x8b9e51aa, 0x6e496c32,
+  0xbcbae7b3, 0x596dda2b, 0x4e51797f, 0xab8644e7, 0xc5cf28d5, 0x2018154d,
+  0x3724b619, 0xd2f38b81, 0x00000000, 0x5d73d985, 0x2eb9ecc2, 0x73ca3547,
+  0x975cf661, 0xca2f2fe4, 0xb9e51aa3, 0xe496c326, 0xcbae7b30, 0x96dda2b5,
+  0xe51797f2, 0xb8644e77, 0x5cf28d51, 0x018154d4, 0x724b6193, 0x2f38b816,
+  0x00000000, 0xd73d985a, 0xeb9ecc2d, 0x3ca35477, 0x75cf6616, 0xa2f2fe4c,
+  0x9e51aa3b, 0x496c3261, 0xbae7b30b, 0x6dda2b51, 0x51797f26, 0x8644e77c,
+  0xcf28d51d, 0x18154d47, 0x24b61930, 0xf38b816a, 0x00000000, 0x73d985a3,
+  0xb9ecc2d1, 0xca354772, 0x5cf66168, 0x2f2fe4cb, 0xe51aa3b9, 0x96c3261a,
+  0xae7b30b4, 0xdda2b517, 0x1797f265, 0x644e77c6, 0xf28d51dc, 0x8154d47f,
+  0x4b61930d, 0x38b816ae, 0x00000000, 0x3d985a3b, 0x9ecc2d1d, 0xa3547726,
+  0xcf66168e, 0xf2fe4cb5, 0x51aa3b93, 0x6c3261a8, 0xe7b30b47, 0xda2b517c,
+  0x797f265a, 0x44e77c61, 0x28d51dc9, 0x154d47f2, 0xb61930d4, 0x8b816aef,
+  0x00000000, 0xd985a3be, 0xecc2d1df, 0x35477261, 0xf66168ef, 0x2fe4cb51,
+  0x1aa3b930, 0xc3261a8e, 0x7b30b477, 0xa2b517c9, 0x97f265a8, 0x4e77c616,
+  0x8d51dc98, 0x54d47f26, 0x61930d47, 0xb816aef9, 0x00000000, 0x985a3be5,
+  0xcc2d1df2, 0x54772617, 0x66168ef9, 0xfe4cb51c, 0xaa3b930b, 0x3261a8ee,
+  0xb30b477c, 0x2b517c99, 0x7f265a8e, 0xe77c616b, 0xd51dc985, 0x4d47f260,
+  0x1930d477, 0x816aef92, 0x00000000, 0x85a3be59, 0xc2d1df2c, 0x47726175,
+  0x6168ef96, 0xe4cb51cf, 0xa3b930ba, 0x261a8ee3, 0x30b477cb, 0xb517c992,
+  0xf265a8e7, 0x77c616be, 0x51dc985d, 0xd47f2604, 0x930d4771, 0x16aef928,
+  0x00000000, 0x5a3be596, 0x2d1df2cb, 0x7726175d, 0x168ef965, 0x4cb51cf3,
+  0x3b930bae, 0x61a8ee38, 0x0b477cb2, 0x517c9924, 0x265a8e79, 0x7c616bef,
+  0x1dc985d7, 0x47f26041, 0x30d4771c, 0x6aef928a, 0x00000000, 0xa3be596d,
+  0xd1df2cb6, 0x726175db, 0x68ef965b, 0xcb51cf36, 0xb930baed, 0x1a8ee380,
+  0xb477cb2d, 0x17c99240, 0x65a8e79b, 0xc616bef6, 0xdc985d76, 0x7f26041b,
+  0x0d4771c0, 0xaef928ad, 0x00000000, 0x3be596d1, 0x1df2cb68, 0x26175db9,
+  0x8ef965b4, 0xb51cf365, 0x930baedc, 0xa8ee380d, 0x477cb2da, 0x7c99240b,
+  0x5a8e79b2, 0x616bef63, 0xc985d76e, 0xf26041bf, 0xd4771c06, 0xef928ad7,
+  0x00000000, 0xbe596d1c, 0xdf2cb68e, 0x6175db92, 0xef965b47, 0x51cf365b,
+  0x30baedc9, 0x8ee380d5, 0x77cb2da3, 0xc99240bf, 0xa8e79b2d, 0x16bef631,
+  0x985d76e4, 0x26041bf8, 0x4771c06a, 0xf928ad76, 0x00000000, 0xe596d1c0,
+  0xf2cb68e0, 0x175db920, 0xf965b470, 0x1cf365b0, 0x0baedc90, 0xee380d50,
+  0x7cb2da38, 0x99240bf8, 0x8e79b2d8, 0x6bef6318, 0x85d76e48, 0x6041bf88,
+  0x771c06a8, 0x928ad768, 0x00000000, 0x596d1c01, 0x2cb68e00, 0x75db9201,
+  0x965b4700, 0xcf365b01, 0xbaedc900, 0xe380d501, 0xcb2da380, 0x9240bf81,
+  0xe79b2d80, 0xbef63181, 0x5d76e480, 0x041bf881, 0x71c06a80, 0x28ad7681,
+  0x00000000, 0x96d1c018, 0xcb68e00c, 0x5db92014, 0x65b47006, 0xf365b01e,
+  0xaedc900a, 0x380d5012, 0xb2da3803, 0x240bf81b, 0x79b2d80f, 0xef631817,
+  0xd76e4805, 0x41bf881d, 0x1c06a809, 0x8ad76811, 0x00000000, 0x6d1c0187,
+  0xb68e00c3, 0xdb920144, 0x5b470061, 0x365b01e6, 0xedc900a2, 0x80d50125,
+  0x2da38030, 0x40bf81b7, 0x9b2d80f3, 0xf6318174, 0x76e48051, 0x1bf881d6,
+  0xc06a8092, 0xad768115, 0x00000000, 0xd1c01879, 0x68e00c3c, 0xb9201445,
+  0xb470061e, 0x65b01e67, 0xdc900a22, 0x0d50125b, 0xda38030f, 0x0bf81b76,
+  0xb2d80f33, 0x6318174a, 0x6e480511, 0xbf881d68, 0x06a8092d, 0xd7681154,
+  0x00000000, 0x1c018790, 0x8e00c3c8, 0x92014458, 0x470061e4, 0x5b01e674,
+  0xc900a22c, 0xd50125bc, 0xa38030f2, 0xbf81b762, 0x2d80f33a, 0x318174aa,
+  0xe4805116, 0xf881d686, 0x6a8092de, 0x7681154e, 0x00000000, 0xc0187906,
+  0xe00c3c83, 0x20144585, 0x70061e41, 0xb01e6747, 0x900a22c2, 0x50125bc4,
+  0x38030f20, 0xf81b7626, 0xd80f33a3, 0x18174aa5, 0x48051161, 0x881d6867,
+  0xa8092de2, 0x681154e4, 0x00000000, 0x01879063, 0x00c3c831, 0x01445852,
+  0x0061e418, 0x01e6747b, 0x00a22c29, 0x0125bc4a, 0x8030f20c, 0x81b7626f,
+  0x80f33a3d, 0x8174aa5e, 0x80511614, 0x81d68677, 0x8092de25, 0x81154e46,
+  0x00000000, 0x18790635, 0x0c3c831a, 0x1445852f, 0x061e418d, 0x1e6747b8,
+  0x0a22c297, 0x125bc4a2, 0x030f20c6, 0x1b7626f3, 0x0f33a3dc, 0x174aa5e9,
+  0x0511614b, 0x1d68677e, 0x092de251, 0x1154e464, 0x00000000, 0x87906352,
+  0xc3c831a9, 0x445852fb, 0x61e418d4, 0xe6747b86, 0xa22c297d, 0x25bc4a2f,
+  0x30f20c6a, 0xb7626f38, 0xf33a3dc3, 0x74aa5e91, 0x511614be, 0xd68677ec,
+  0x92de2517, 0x154e4645, 0x00000000, 0x79063521, 0x3c831a90, 0x45852fb1,
+  0x1e418d48, 0x6747b869, 0x22c297d8, 0x5bc4a2f9, 0x0f20c6a4, 0x7626f385,
+  0x33a3dc34, 0x4aa5e915, 0x11614bec, 0x68677ecd, 0x2de2517c, 0x54e4645d,
+  0x00000000, 0x90635215, 0xc831a90a, 0x5852fb1f, 0xe418d485, 0x747b8690,
+  0x2c297d8f, 0xbc4a2f9a, 0xf20c6a42, 0x626f3857, 0x3a3dc348, 0xaa5e915d,
+  0x1614bec7, 0x8677ecd2, 0xde2517cd, 0x4e4645d8, 0x00000000, 0x0635215b,
+  0x831a90ad, 0x852fb1f6, 0x418d4856, 0x47b8690d, 0xc297d8fb, 0xc4a2f9a0,
+  0x20c6a42b, 0x26f38570, 0xa3dc3486, 0xa5e915dd, 0x614bec7d, 0x677ecd26,
+  0xe2517cd0, 0xe4645d8b, 0x00000000, 0x635215b9, 0x31a90adc, 0x52fb1f65,
+  0x18d4856e, 0x7b8690d7, 0x297d8fb2, 0x4a2f9a0b, 0x0c6a42b7, 0x6f38570e,
+  0x3dc3486b, 0x5e915dd2, 0x14bec7d9, 0x77ecd260, 0x2517cd05, 0x4645d8bc,
+  0x00000000, 0x35215b9d, 0x1a90adce, 0x2fb1f653, 0x8d4856e7, 0xb8690d7a,
+  0x97d8fb29, 0xa2f9a0b4, 0xc6a42b73, 0xf38570ee, 0xdc3486bd, 0xe915dd20,
+  0x4bec7d94, 0x7ecd2609, 0x517cd05a, 0x645d8bc7, 0x00000000, 0x5215b9dd,
+  0xa90adcee, 0xfb1f6533, 0xd4856e77, 0x8690d7aa, 0x7d8fb299, 0x2f9a0b44,
+  0x6a42b73b, 0x38570ee6, 0xc3486bd5, 0x915dd208, 0xbec7d94c, 0xecd26091,
+  0x17cd05a2, 0x45d8bc7f, 0x00000000, 0x215b9ddf, 0x90adceef, 0xb1f65330,
+  0x4856e777, 0x690d7aa8, 0xd8fb2998, 0xf9a0b447, 0xa42b73bb, 0x8570ee64,
+  0x3486bd54, 0x15dd208b, 0xec7d94cc, 0xcd260913, 0x7cd05a23, 0x5d8bc7fc,
+  0x00000000, 0x15b9ddf5, 0x0adceefa, 0x1f65330f, 0x856e777d, 0x90d7aa88,
+  0x8fb29987, 0x9a0b4472, 0x42b73bbe, 0x570ee64b, 0x486bd544, 0x5dd208b1,
+  0xc7d94cc3, 0xd2609136, 0xcd05a239, 0xd8bc7fcc, 0x00000000, 0x5b9ddf56,
+  0xadceefab, 0xf65330fd, 0x56e777d5, 0x0d7aa883, 0xfb29987e, 0xa0b44728,
+  0x2b73bbea, 0x70ee64bc, 0x86bd5441, 0xdd208b17, 0x7d94cc3f, 0x26091369,
+  0xd05a2394, 0x8bc7fcc2, 0x00000000, 0xb9ddf560, 0xdceefab0, 0x65330fd0,
+  0x6e777d58, 0xd7aa8838, 0xb29987e8, 0x0b447288, 0xb73bbeac, 0x0ee64bcc,
+  0x6bd5441c, 0xd208b17c, 0xd94cc3f4, 0x60913694, 0x05a23944, 0xbc7fcc24,
+  0x00000000, 0x9ddf5600, 0xceefab00, 0x5330fd00, 0xe777d580, 0x7aa88380,
+  0x29987e80, 0xb4472880, 0x73bbeac0, 0xee64bcc0, 0xbd5441c0, 0x208b17c0,
+  0x94cc3f40, 0x09136940, 0x5a239440, 0xc7fcc240, 0x00000000, 0xddf5600f,
+  0xeefab007, 0x330fd008, 0x777d5803, 0xaa88380c, 0x9987e804, 0x4472880b,
+  0x3bbeac01, 0xe64bcc0e, 0xd5441c06, 0x08b17c09, 0x4cc3f402, 0x9136940d,
+  0xa2394405, 0x7fcc240a, 0x00000000, 0xdf5600fd, 0xefab007e, 0x30fd0083,
+  0x77d5803f, 0xa88380c2, 0x987e8041, 0x472880bc, 0xbbeac01f, 0x64bcc0e2,
+  0x5441c061, 0x8b17c09c, 0xcc3f4020, 0x136940dd, 0x2394405e, 0xfcc240a3
 };
 
 static const uint32_t g_crc32c_table[256] =
@@ -131,7 +321,8 @@ static const uint32_t g_crc32c_table[256] =
  * Description:
  *   HASHCAL_ALGO_TOEPLITZ is a hash algorithm that uses Toeplitz matrix to
  *   calculate hash values. Toeplitz matrix is a special matrix where each
- *   diagonal has the same elements.
+ *   diagonal has the same elements.  The hash is taken a nibble at a time
+ *   from g_toeplitz_table.
  *
  * Input Parameters:
  *   packet - The packet data
@@ -145,28 +336,15 @@ static const uint32_t g_crc32c_table[256] =
 static uint32_t compute_toeplitz_hash(FAR const uint8_t *packet,
                                       uint32_t len)
 {
-  uint32_t key = (g_random_key.u8[0] << 24) | (g_random_key.u8[1] << 16) |
-                 (g_random_key.u8[2] << 8) | g_random_key.u8[3];
+  FAR const uint32_t *table = g_toeplitz_table;
   uint32_t ret = 0;
-  int i;
-  int j;
+  uint32_t i;
 
-  for (i = 0; i < len; i++)
+  DEBUGASSERT(len <= PACKET_BYTE_SIZE);
+
+  for (i = 0; i < len; i++, table += 32)
     {
-      for (j = 0; j < 8; j++)
-        {
-          if (packet[i] & (1 << (7 - j)))
-            {
-              ret ^= key;
-            }
-
-          key <<= 1;
-          if ((i + 4) < RANDOM_KEY_SIZE &&
-              (g_random_key.u8[i + 4] & (1 << (7 - j))))
-            {
-              key |= 1;
-            }
-        }
+      ret ^= table[packet[i] >> 4] ^ table[16 + (packet[i] & 0x0f)];
     }
 
   return ret;
@@ -243,17 +421,18 @@ static uint32_t compute_crc32c_hash(FAR uint8_t *packet, uint32_t len)
  * Name: create_binary
  *
  * Description:
- *   Create a binary representation of the specified data structure and
- *   return a length of binary data
+ *   Create the binary input of the hash from the addresses and ports in
+ *   network order, laid out as in the received packets and as hashed by
+ *   RSS hardware, and return the length of the binary data
  *
  * Input Parameters:
  *   hash_type - The hash type
  *   domain    - The layer 3 protocol, PF_INET/PF_INET6
- *   packet    - The packet data
  *   src_addr  - The source address
  *   src_port  - The source port
  *   dst_addr  - The destination address
  *   dst_port  - The destination port
+ *   packet    - The location to return the binary data
  *
  * Returned Value:
  *  The length of the packet need to be calculated
@@ -261,70 +440,35 @@ static uint32_t compute_crc32c_hash(FAR uint8_t *packet, uint32_t len)
  ****************************************************************************/
 
 static uint32_t create_binary(hashcal_type_e hash_type, uint8_t domain,
-                              FAR const uint32_t *src_addr,
+                              FAR const void *src_addr,
                               uint16_t src_port,
-                              FAR const uint32_t *dst_addr,
+                              FAR const void *dst_addr,
                               uint16_t dst_port,
                               FAR uint8_t *packet)
 {
+  uint32_t addrlen;
   uint32_t iter = 0;
 
   if (domain == PF_INET)
     {
-      packet[iter++] = (*src_addr & 0xff000000) >> 24;
-      packet[iter++] = (*src_addr & 0x00ff0000) >> 16;
-      packet[iter++] = (*src_addr & 0x0000ff00) >> 8;
-      packet[iter++] = (*src_addr & 0x000000ff);
-
-      packet[iter++] = (*dst_addr & 0xff000000) >> 24;
-      packet[iter++] = (*dst_addr & 0x00ff0000) >> 16;
-      packet[iter++] = (*dst_addr & 0x0000ff00) >> 8;
-      packet[iter++] = (*dst_addr & 0x000000ff);
-
-      if (hash_type == HASHCAL_TYPE_4TUPLE)
-        {
-          packet[iter++] = (src_port & 0xff00) >> 8;
-          packet[iter++] = (src_port & 0x00ff);
-          packet[iter++] = (dst_port & 0xff00) >> 8;
-          packet[iter++] = (dst_port & 0x00ff);
-        }
+      addrlen = sizeof(in_addr_t);
     }
   else
     {
-      uint32_t tmp;
-      int i;
-      int j;
-
-      for (i = 0, j = 0; i < 16; i++)
-        {
-          if (0 < i && i % 4 == 0)
-            {
-              j++;
-            }
+      addrlen = sizeof(net_ipv6addr_t);
+    }
 
-          tmp = src_addr[j];
-          packet[i] = tmp >> (24 - (8 * (i % 4)));
-        }
+  memcpy(&packet[iter], src_addr, addrlen);
+  iter += addrlen;
+  memcpy(&packet[iter], dst_addr, addrlen);
+  iter += addrlen;
 
-      for (i = 16, j = 0; i < 32; i++)
-        {
-          if (16 < i && i % 4 == 0)
-            {
-              j++;
-            }
-
-          tmp = dst_addr[j];
-          packet[i] = tmp >> (24 - (8 * (i % 4)));
-        }
-
-      iter = 32;
-      if (hash_type == HASHCAL_TYPE_4TUPLE)
-        {
-          packet[iter++] = (src_port & 0xff00) >> 8;
-          packet[iter++] = (src_port & 0x00ff);
-          packet[iter++] = (dst_port & 0xff00) >> 8;
-          packet[iter++] = (dst_port & 0x00ff);
-        }
+  if (hash_type == HASHCAL_TYPE_4TUPLE)
+    {
+      memcpy(&packet[iter], &src_port, sizeof(uint16_t));
+      iter += sizeof(uint16_t);
+      memcpy(&packet[iter], &dst_port, sizeof(uint16_t));
+      iter += sizeof(uint16_t);
     }
 
   return iter;
@@ -352,8 +496,8 @@ static uint32_t create_binary(hashcal_type_e hash_type, uint8_t domain,
 
 static uint32_t compute_hash(hashcal_algo_e hash_algo,
                              hashcal_type_e hash_type, uint8_t domain,
-                             FAR const uint32_t *src_addr, uint16_t src_port,
-                             FAR const uint32_t *dst_addr, uint16_t dst_port)
+                             FAR const void *src_addr, uint16_t src_port,
+                             FAR const void *dst_addr, uint16_t dst_port)
 {
   uint8_t packet[PACKET_BYTE_SIZE];
   uint32_t hash_val;
@@ -390,11 +534,40 @@ static uint32_t compute_hash(hashcal_algo_e hash_algo,
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: netdev_rss_hash
+ *
+ * Description:
+ *   Calculate the RSS hash of a TCP or UDP flow with the Toeplitz function
+ *   and the key used by RSS hardware, over the addresses and ports as they
+ *   are in the received packets.
+ *
+ * Input Parameters:
+ *   domain   - The layer 3 protocol, PF_INET/PF_INET6
+ *   src_addr - The source address of the packets, in network order
+ *   src_port - The source port of the packets, in network order
+ *   dst_addr - The destination address of the packets, in network order
+ *   dst_port - The destination port of the packets, in network order
+ *
+ * Returned Value:
+ *   The hash value of the flow
+ *
+ ****************************************************************************/
+
+uint32_t netdev_rss_hash(uint8_t domain,
+                         FAR const void *src_addr, uint16_t src_port,
+                         FAR const void *dst_addr, uint16_t dst_port)
+{
+  return compute_hash(HASHCAL_ALGO_TOEPLITZ, HASHCAL_TYPE_4TUPLE, domain,
+                      src_addr, src_port, dst_addr, dst_port);
+}
+
 /****************************************************************************
  * Name: netdev_notify_recvcpu
  *
  * Description:
- *   Notify the cpu id for the network device driver.
+ *   Notify the cpu id for the network device driver, with the RSS hash of
+ *   the packets received by the connection.
  *
  * Input Parameters:
  *   dev      - The network device driver state structure
@@ -417,11 +590,12 @@ void netdev_notify_recvcpu(FAR struct net_driver_s *dev,
 {
   if (dev != NULL && dev->d_ioctl != NULL)
     {
-      uint32_t hash = compute_hash(HASHCAL_ALGO_CRC32,
-                                   HASHCAL_TYPE_4TUPLE,
-                                   domain,
-                                   src_addr, src_port,
-                                   dst_addr, dst_port);
+      /* The local address of the connection is the destination of the
+       * received packets.
+       */
+
+      uint32_t hash = netdev_rss_hash(domain, dst_addr, dst_port,
+                                      src_addr, src_port);
       struct netdev_rss_s arg;
       int ret;
 
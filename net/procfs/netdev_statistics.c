@@ -56,6 +56,25 @@
 #  define NETSTAT_IPv6_IDX 1
 #endif
 
+/* The per-queue statistics follow the link layer, the addresses, the RX/TX
+ * statistics and their header.
+ */
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_MULTIQUEUE)
+#  if defined(CONFIG_NET_IPv6) && defined(CONFIG_NETDEV_MULTIPLE_IPv6) && \
+      defined(CONFIG_DESIGNATED_INITIALIZERS)
+#    define NETSTAT_STATS_IDX \
+       (NETSTAT_IPv6_IDX + CONFIG_NETDEV_MAX_IPv6_ADDR + 1)
+#  elif defined(CONFIG_NET_IPv6)
+#    define NETSTAT_STATS_IDX (NETSTAT_IPv6_IDX + 2)
+#  elif defined(CONFIG_NET_IPv4)
+#    define NETSTAT_STATS_IDX NETSTAT_IPv6_IDX
+#  else
+#    define NETSTAT_STATS_IDX (NETSTAT_IPv6_IDX + 1)
+#  endif
+#  define NETSTAT_QUEUE_IDX (NETSTAT_STATS_IDX + 7)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -80,6 +99,11 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics_header(
     FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int netprocfs_queuestatistics_header(
+    FAR struct netprocfs_file_s *netfile);
+static int netprocfs_queuestatistics(FAR struct netprocfs_file_s *netfile);
+#endif
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -116,6 +140,15 @@ static const linegen_t g_netstat_linegen[] =
   netprocfs_rxpackets,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
+#  ifdef CONFIG_NETDEV_MULTIQUEUE
+  netprocfs_queuestatistics_header,
+#    ifdef CONFIG_DESIGNATED_INITIALIZERS
+  [NETSTAT_QUEUE_IDX ... NETSTAT_QUEUE_IDX + CONFIG_NETDEV_MAX_QUEUES - 1]
+  = netprocfs_queuestatistics,
+#    else
+  netprocfs_queuestatistics,
+#    endif
+#  endif
   netprocfs_errors
 #endif /* CONFIG_NETDEV_STATISTICS */
 };
@@ -558,6 +591,61 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_queuestatistics_header
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_MULTIQUEUE)
+static int netprocfs_queuestatistics_header(
+    FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+
+  if (netfile->dev->d_nqueues <= 1)
+    {
+      return 0;
+    }
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\tQ:  %-8s %-8s %-16s %-8s %-8s %-16s\n",
+                  "Received", "Steered", "Bytes", "Queued", "Sent",
+                  "Bytes");
+}
+#endif /* CONFIG_NETDEV_STATISTICS && CONFIG_NETDEV_MULTIQUEUE */
+
+/****************************************************************************
+ * Name: netprocfs_queuestatistics
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_MULTIQUEUE)
+static int netprocfs_queuestatistics(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_queue_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+  int qid = netfile->lineno - NETSTAT_QUEUE_IDX;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+
+  if (dev->d_nqueues <= 1 || qid >= dev->d_nqueues)
+    {
+      return 0;
+    }
+
+  stats = &dev->d_qstatistics[qid];
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\t%-3d %08lx %08lx %-16llx %08lx %08lx %-16llx\n",
+                  qid,
+                  (unsigned long)stats->rx_packets,
+                  (unsigned long)stats->rx_steered,
+                  (unsigned long long)stats->rx_bytes,
+                  (unsigned long)stats->tx_packets,
+                  (unsigned long)stats->tx_done,
+                  (unsigned long long)stats->tx_bytes);
+}
+#endif /* CONFIG_NETDEV_STATISTICS && CONFIG_NETDEV_MULTIQUEUE */
+
 /****************************************************************************
  * Name: netprocfs_errors
  ****************************************************************************/
@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -95,10 +96,102 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The connected TCP connections hashed by their local port, remote port and
+ * remote address, which are all known once a connection is active.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_conn_hash, CONFIG_NET_TCP_HASH_BITS);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_ipv4_hashkey
+ *
+ * Description:
+ *   Create the hash key of an IPv4 connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_hashkey(uint16_t lport, uint16_t rport,
+                                        in_addr_t raddr)
+{
+  return NTOHL(raddr) ^ ((uint32_t)rport << 16) ^ lport;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_ipv6_hashkey
+ *
+ * Description:
+ *   Create the hash key of an IPv6 connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_hashkey(uint16_t lport, uint16_t rport,
+                                        const net_ipv6addr_t raddr)
+{
+  uint32_t key = (((uint32_t)raddr[0] << 16) | raddr[1]) ^
+                 (((uint32_t)raddr[2] << 16) | raddr[3]) ^
+                 (((uint32_t)raddr[4] << 16) | raddr[5]) ^
+                 (((uint32_t)raddr[6] << 16) | raddr[7]);
+
+  return key ^ ((uint32_t)rport << 16) ^ lport;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_hashkey
+ *
+ * Description:
+ *   Create the hash key of an active connection.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_hashkey(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_ipv4_hashkey(conn->lport, conn->rport,
+                              conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_ipv6_hashkey(conn->lport, conn->rport,
+                              conn->u.ipv6.raddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_addconn
+ *
+ * Description:
+ *   Add the connection to the list and the hashtable of active TCP
+ *   connections.  The local and remote ports and address must be set.
+ *
+ * Assumptions:
+ *   The TCP connection list is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addconn(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  hashtable_add(g_tcp_conn_hash, &conn->hashnode, tcp_conn_hashkey(conn));
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -168,15 +261,23 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *node;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
-  while (conn)
+  /* Only the connections in the bucket of the ports and the source
+   * address of the segment can match.
+   */
+
+  hashtable_for_every_possible(g_tcp_conn_hash, node,
+                               tcp_ipv4_hashkey(tcp->destport,
+                                                tcp->srcport, srcipaddr))
     {
+      conn = container_of(node, struct tcp_conn_s, hashnode);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -201,19 +302,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -235,15 +330,23 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *node;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
-  while (conn)
+  /* Only the connections in the bucket of the ports and the source
+   * address of the segment can match.
+   */
+
+  hashtable_for_every_possible(g_tcp_conn_hash, node,
+                               tcp_ipv6_hashkey(tcp->destport,
+                                                tcp->srcport, *srcipaddr))
     {
+      conn = container_of(node, struct tcp_conn_s, hashnode);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -268,19 +371,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -689,6 +786,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       conn->keepintvl     = 2 * DSEC_PER_SEC;
       conn->keepcnt       = 3;
 #endif
+#ifdef CONFIG_NETDEV_RSS
+      conn->rcvcpu        = -1;
+#endif
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcv_bufs      = CONFIG_NET_RECV_BUFSIZE;
 #endif
@@ -812,7 +912,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       tcp_conn_list_lock();
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_removeconn(conn);
       tcp_conn_list_unlock();
     }
 
@@ -1181,7 +1281,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       tcp_conn_list_lock();
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addconn(conn);
       tcp_conn_list_unlock();
 
       tcp_update_retrantimer(conn, TCP_RTO);
@@ -1490,7 +1590,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   tcp_conn_list_lock();
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addconn(conn);
   tcp_conn_list_unlock();
 
   return OK;
@@ -1536,6 +1636,8 @@ void tcp_conn_list_unlock(void)
 void tcp_removeconn(FAR struct tcp_conn_s *conn)
 {
   dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+  hashtable_delete(g_tcp_conn_hash, &conn->hashnode,
+                   tcp_conn_hashkey(conn));
 }
 
 /****************************************************************************
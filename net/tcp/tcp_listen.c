@@ -50,6 +50,7 @@
 #include <stdbool.h>
 #include <nuttx/debug.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 
@@ -57,13 +58,31 @@
 #include "inet/inet.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The listeners are hashed by their local port, with about one bucket for
+ * each listening port.
+ */
+
+#if CONFIG_NET_MAX_LISTENPORTS > 2
+#  define TCP_LISTEN_HASH_BITS LOG2_CEIL(CONFIG_NET_MAX_LISTENPORTS)
+#else
+#  define TCP_LISTEN_HASH_BITS 1
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* The tcp_listenports list all currently listening ports. */
+/* The tcp_listenports hashtable holds all currently listening ports. */
+
+static DECLARE_HASHTABLE(tcp_listenports, TCP_LISTEN_HASH_BITS);
 
-static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+/* The number of connections in tcp_listenports */
+
+static int tcp_nlistenports;
 
 /****************************************************************************
  * Private Functions
@@ -89,18 +108,17 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
-  int ndx;
+  FAR hash_node_t *node;
 
-  /* Examine each connection structure in each slot of the listener list */
+  /* Examine each listener hashed to the same bucket as the port */
 
   tcp_conn_list_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  hashtable_for_every_possible(tcp_listenports, node, portno)
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
+      /* Does the connection have the same local port number? */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+      FAR struct tcp_conn_s *conn =
+        container_of(node, struct tcp_conn_s, listennode);
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (tcp_conn_cmp(domain, (FAR const union ip_addr_u *)uaddr, portno,
                        conn))
@@ -136,15 +154,16 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR hash_node_t *node;
   int ret = -EINVAL;
 
   tcp_conn_list_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  hashtable_for_every_possible(tcp_listenports, node, conn->lport)
     {
-      if (tcp_listenports[ndx] == conn)
+      if (node == &conn->listennode)
         {
-          tcp_listenports[ndx] = NULL;
+          hashtable_delete(tcp_listenports, node, conn->lport);
+          tcp_nlistenports--;
           tcp_remove_syn_backlog(conn);
           ret = OK;
           break;
@@ -168,7 +187,6 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -189,29 +207,19 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -EADDRINUSE;
     }
+  else if (tcp_nlistenports >= CONFIG_NET_MAX_LISTENPORTS)
+    {
+      ret = -ENOBUFS;
+    }
   else
     {
       /* Otherwise, save a reference to the connection structure in the
-       * "listener" list.
+       * "listener" hashtable.
        */
 
-      ret = -ENOBUFS; /* Assume failure */
-
-      /* Search all slots until an available slot is found */
-
-      for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
-        {
-          /* Is the next slot available? */
-
-          if (!tcp_listenports[ndx])
-            {
-              /* Yes.. we found it */
-
-              tcp_listenports[ndx] = conn;
-              ret = OK;
-              break;
-            }
-        }
+      hashtable_add(tcp_listenports, &conn->listennode, conn->lport);
+      tcp_nlistenports++;
+      ret = OK;
     }
 
   tcp_conn_list_unlock();
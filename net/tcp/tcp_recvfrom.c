@@ -32,6 +32,7 @@
 #include <nuttx/debug.h>
 #include <assert.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/tls.h>
 #include <nuttx/net/net.h>
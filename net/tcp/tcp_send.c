@@ -65,6 +65,21 @@
 #include "tcp/tcp.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A packet above the MTU is segmented by the device (NETDEV_TX_GSO), which
+ * computes the TCP checksum of every segment.
+ */
+
+#ifdef CONFIG_NETDEV_GSO
+#  define TCP_IS_GSO(dev) \
+     ((dev)->d_len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev))
+#else
+#  define TCP_IS_GSO(dev) false
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -200,7 +215,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if ((dev->d_features & NETDEV_TX_CSUM) == 0 && !TCP_IS_GSO(dev))
         {
           tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
         }
@@ -222,12 +237,25 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                         &dev->d_ipaddr, &conn->u.ipv4.raddr,
                         conn->sconn.s_ttl, conn->sconn.s_tos, NULL);
 
+#ifdef CONFIG_NETDEV_GSO
+      if (TCP_IS_GSO(dev))
+        {
+          uint16_t hdrlen = IPv4_HDRLEN + ((tcp->tcpoffset >> 4) << 2);
+          uint16_t segsize = NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) -
+                             hdrlen;
+
+          /* The following segments get the next IDs from the device */
+
+          ipv4_reserve_ipid((dev->d_len - hdrlen - 1) / segsize);
+        }
+#endif
+
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if ((dev->d_features & NETDEV_TX_CSUM) == 0 && !TCP_IS_GSO(dev))
         {
           tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
         }
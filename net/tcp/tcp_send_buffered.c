@@ -141,6 +141,48 @@ static void psock_insert_segment(FAR struct tcp_wrbuffer_s *wrb,
     }
 }
 
+/****************************************************************************
+ * Name: tcp_send_maxlen
+ *
+ * Description:
+ *   Return the largest amount of data to send in one packet.  This is the
+ *   MSS, or a multiple of it if the device segments the packets itself
+ *   (NETDEV_TX_GSO).  The device splits them to its MTU, so this is only
+ *   done when the MSS is not limited below that by the peer or the path.
+ *
+ * Input Parameters:
+ *   dev   The device the packet is sent on
+ *   conn  The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   The largest amount of data to send
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_send_maxlen(FAR struct net_driver_s *dev,
+                                FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t hdrlen = tcpip_hdrsize(conn);
+
+  if ((dev->d_features & NETDEV_TX_GSO) != 0 &&
+      conn->mss == NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - hdrlen)
+    {
+      uint32_t maxlen = CONFIG_NETDEV_GSO_MAXSIZE - hdrlen;
+
+      if (maxlen > conn->mss)
+        {
+          return maxlen - maxlen % conn->mss;
+        }
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: psock_writebuffer_notify
  *
@@ -1059,12 +1101,14 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       if (TCP_SEQ_LT(seq, snd_wnd_edge))
         {
           uint32_t remaining_snd_wnd;
+          uint32_t maxlen;
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          maxlen = tcp_send_maxlen(dev, conn);
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1223,6 +1267,15 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 
   size = 4 * mss;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* or enough for a packet segmented by the device, if it takes them */
+
+  if (conn->dev != NULL && size < tcp_send_maxlen(conn->dev, conn))
+    {
+      size = tcp_send_maxlen(conn->dev, conn);
+    }
+#endif
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -116,6 +117,7 @@ struct udp_conn_s
   uint8_t  flags;         /* See _UDP_FLAG_* definitions */
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  crefs;         /* Reference counts on this instance */
+  hash_node_t hashnode;   /* Entry in the hashtable of bound connections */
 
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcvbufs;       /* Maximum amount of bytes queued in recv */
@@ -240,6 +242,26 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_conn_s *conn,
                                   FAR struct udp_hdr_s *udp);
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   If the connection returned by udp_active() is a member of a group of
+ *   sockets bound to the same address and port with SO_REUSEPORT, select
+ *   the member that receives the unicast UDP packet by the hash of its
+ *   source address and port.  All packets of a flow go to the same member.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the UDP connection list locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp);
+#endif
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -298,6 +320,22 @@ void udp_conn_list_unlock(void);
 
 uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u);
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of the connection and move it to the matching
+ *   bucket of the hashtable used to look up the connection of received
+ *   UDP packets.  A port of zero leaves the connection unbound.
+ *
+ * Input Parameters:
+ *   conn   - A reference to UDP connection structure
+ *   portno - The local port number in network byte order
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_bind
  *
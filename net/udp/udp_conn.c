@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/net/netconfig.h>
@@ -82,6 +83,11 @@
 #  define CONFIG_NET_UDP_MAX_CONNS 0
 #endif
 
+/* The bucket of the hashtable holding the connections bound to a port */
+
+#define UDP_CONN_BUCKET(portno) \
+  (&g_udp_conn_hash[HASH(portno, hashtable_bits(g_udp_conn_hash))])
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -96,10 +102,45 @@ NET_BUFPOOL_DECLARE(g_udp_connections, sizeof(struct udp_conn_s),
 
 static dq_queue_t g_active_udp_connections;
 
+/* The connections with a local port, hashed by the port */
+
+static DECLARE_HASHTABLE(g_udp_conn_hash, CONFIG_NET_UDP_HASH_BITS);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_nexthash
+ *
+ * Description:
+ *   Traverse the UDP connections in the hashtable bucket of the local port.
+ *   The connections of other ports hashed to the same bucket are returned
+ *   too, the caller must check the port.
+ *
+ * Assumptions:
+ *   This function must be called with the udp_conn_list_lock.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+udp_nexthash(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  FAR hash_node_t *node;
+
+  if (conn == NULL)
+    {
+      node = dq_peek(UDP_CONN_BUCKET(portno));
+    }
+  else
+    {
+      node = dq_next(&conn->hashnode);
+    }
+
+  return node != NULL ? container_of(node, struct udp_conn_s, hashnode) :
+                        NULL;
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -112,6 +153,8 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never conflict.
+ *              SO_REUSEPORT: If both sockets have this, they never conflict
+ *                            and share the packets of the port.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -125,19 +168,23 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   FAR struct udp_conn_s *conn = NULL;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
 #endif
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure bound to the port. */
 
   udp_conn_list_lock();
-  while ((conn = udp_nextconn(conn)) != NULL)
+  while ((conn = udp_nexthash(conn, portno)) != NULL)
     {
-      /* With SO_REUSEADDR set for both sockets, we do not need to check its
-       * address and port.
+      /* With SO_REUSEADDR or SO_REUSEPORT set for both sockets, we do not
+       * need to check its address and port.
        */
 
 #ifdef CONFIG_NET_SOCKOPTS
-      if (skip_reusable && _SO_GETOPT(conn->sconn.s_options, SO_REUSEADDR))
+      if ((skip_reusable &&
+           _SO_GETOPT(conn->sconn.s_options, SO_REUSEADDR)) ||
+          (skip_reuseport &&
+           _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT)))
         {
           continue;
         }
@@ -204,7 +251,11 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  /* Only the connections in the bucket of the destination port can
+   * match.
+   */
+
+  conn = udp_nexthash(conn, udp->destport);
 
   while (conn)
     {
@@ -316,9 +367,9 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection bound to the port */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nexthash(conn, udp->destport);
     }
 
   return conn;
@@ -344,7 +395,11 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  /* Only the connections in the bucket of the destination port can
+   * match.
+   */
+
+  conn = udp_nexthash(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -456,15 +511,97 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection bound to the port */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nexthash(conn, udp->destport);
     }
 
   return conn;
 }
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: udp_reuseport_member
+ *
+ * Description:
+ *   Return true if the connection is a member of the SO_REUSEPORT group of
+ *   the first connection, i.e. it is not in connection mode and bound to
+ *   the same address and port with SO_REUSEPORT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool udp_reuseport_member(FAR struct udp_conn_s *first,
+                                 FAR struct udp_conn_s *conn)
+{
+  if (conn->lport != first->lport || conn->domain != first->domain ||
+      !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) ||
+      _UDP_ISCONNECTMODE(conn->flags))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, first->u.ipv4.laddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, first->u.ipv6.laddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: udp_flowhash
+ *
+ * Description:
+ *   Hash the source address and port of the received UDP packet.
+ *
+ ****************************************************************************/
+
+static uint32_t udp_flowhash(FAR struct net_driver_s *dev,
+                             FAR struct udp_hdr_s *udp)
+{
+  uint32_t key;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+
+      key = (((uint32_t)ip->srcipaddr[0] << 16) | ip->srcipaddr[1]) ^
+            (((uint32_t)ip->srcipaddr[2] << 16) | ip->srcipaddr[3]) ^
+            (((uint32_t)ip->srcipaddr[4] << 16) | ip->srcipaddr[5]) ^
+            (((uint32_t)ip->srcipaddr[6] << 16) | ip->srcipaddr[7]);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+      key = NTOHL(net_ip4addr_conv32(ip->srcipaddr));
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return HASH(key ^ udp->srcport, 16);
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -533,6 +670,39 @@ uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
   return portno;
 }
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of the connection and move it to the matching
+ *   bucket of the hashtable used to look up the connection of received
+ *   UDP packets.  A port of zero leaves the connection unbound.
+ *
+ * Input Parameters:
+ *   conn   - A reference to UDP connection structure
+ *   portno - The local port number in network byte order
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  udp_conn_list_lock();
+
+  if (conn->lport != 0)
+    {
+      hashtable_delete(g_udp_conn_hash, &conn->hashnode, conn->lport);
+    }
+
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      hashtable_add(g_udp_conn_hash, &conn->hashnode, portno);
+    }
+
+  udp_conn_list_unlock();
+}
+
 /****************************************************************************
  * Name: udp_alloc
  *
@@ -562,6 +732,9 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       conn->domain      = domain;
 #endif
       conn->lport       = 0;
+#ifdef CONFIG_NETDEV_RSS
+      conn->rcvcpu      = -1;
+#endif
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcvbufs     = CONFIG_NET_RECV_BUFSIZE;
 #endif
@@ -606,11 +779,18 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   NET_BUFPOOL_LOCK(g_udp_connections);
-  conn->lport = 0;
+  udp_setport(conn, 0);
 
   /* Remove the connection from the active list */
 
   dq_rem(&conn->sconn.node, &g_active_udp_connections);
+
+  /* udp_input() may still be delivering a packet to the connection that
+   * was found before it was removed, wait for it to finish.
+   */
+
+  conn_lock(&conn->sconn);
+  conn_unlock(&conn->sconn);
   nxrmutex_destroy(&conn->sconn.s_lock);
 
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
@@ -680,6 +860,65 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   If the connection returned by udp_active() is a member of a group of
+ *   sockets bound to the same address and port with SO_REUSEPORT, select
+ *   the member that receives the unicast UDP packet by the hash of its
+ *   source address and port.  All packets of a flow go to the same member.
+ *
+ * Assumptions:
+ *   This function must be called with the udp_conn_list_lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *member;
+  uint32_t index;
+  uint32_t nmembers = 0;
+
+  if (!udp_reuseport_member(conn, conn))
+    {
+      return conn;
+    }
+
+  /* The members follow the first matching connection in the bucket of
+   * the port, count them.
+   */
+
+  for (member = conn; member != NULL;
+       member = udp_nexthash(member, conn->lport))
+    {
+      if (udp_reuseport_member(conn, member))
+        {
+          nmembers++;
+        }
+    }
+
+  if (nmembers == 1)
+    {
+      return conn;
+    }
+
+  /* And take the member selected by the flow */
+
+  index = udp_flowhash(dev, udp) % nmembers;
+  for (member = conn; ; member = udp_nexthash(member, conn->lport))
+    {
+      if (udp_reuseport_member(conn, member) && index-- == 0)
+        {
+          return member;
+        }
+    }
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Name: udp_conn_list_lock
  *
@@ -762,8 +1001,12 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     }
 #endif
 
-  /* Interrupts must be disabled while access the UDP connection list */
+  /* Hold the connection list from the lookup of the port until the
+   * connection is hashed to it, taken before conn_lock() as in the receive
+   * path.
+   */
 
+  udp_conn_list_lock();
   conn_lock(&conn->sconn);
 
 #ifdef CONFIG_NET_IPv4
@@ -795,6 +1038,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
           if (ret == -EADDRNOTAVAIL)
             {
               conn_unlock(&conn->sconn);
+              udp_conn_list_unlock();
               return ret;
             }
         }
@@ -845,6 +1089,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
           if (ret == -EADDRNOTAVAIL)
             {
               conn_unlock(&conn->sconn);
+              udp_conn_list_unlock();
               return ret;
             }
         }
@@ -876,7 +1121,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
     }
@@ -901,7 +1146,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -911,6 +1156,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     }
 
   conn_unlock(&conn->sconn);
+  udp_conn_list_unlock();
   return ret;
 }
 
@@ -953,7 +1199,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
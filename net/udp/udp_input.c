@@ -305,6 +305,19 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
       conn = udp_active(dev, NULL, udp);
       if (conn)
         {
+#ifdef CONFIG_NET_SOCKOPTS
+#ifdef CONFIG_NET_BROADCAST
+          if (!udp_is_broadcast(dev))
+#endif
+            {
+              /* A unicast packet goes to one member of a SO_REUSEPORT
+               * group, selected by its flow.
+               */
+
+              conn = udp_reuseport_select(dev, conn, udp);
+            }
+#endif
+
           /* We'll only get multiple conn when we support SO_REUSEADDR */
 
 #if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_BROADCAST)
@@ -342,9 +355,26 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
             }
 #endif
 
+          /* Hold the last listener, udp_free() waits for its lock before
+           * the connection is freed.
+           */
+
+          conn_lock(&conn->sconn);
+        }
+
+      /* The packet is delivered to the last listener without the lock of
+       * the connection list, so that the other devices can look up their
+       * connections in the meantime.
+       */
+
+      udp_conn_list_unlock();
+
+      if (conn)
+        {
           /* We can deliver the packet directly to the last listener. */
 
           ret = udp_input_conn(dev, conn, udpiplen);
+          conn_unlock(&conn->sconn);
         }
 #ifdef CONFIG_NET_BROADCAST
       else if (udp_is_broadcast(dev))
@@ -394,8 +424,6 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 #  endif /* CONFIG_NET_IPv6*/
 #endif
         }
-
-      udp_conn_list_unlock();
     }
 
   return ret;
@@ -33,6 +33,7 @@
 #include <assert.h>
 
 #include <sys/time.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -609,6 +610,7 @@ static ssize_t udp_recvfrom_result(int result, struct udp_recvfrom_s *pstate)
  *   not same, then use netdev_notify_recvcpu to notify the new cpu id
  *
  * Input Parameters:
+ *   dev     - The device receiving the packets of the connection.
  *   conn    - A reference to UDP connection structure.
  *
  * Returned Value:
@@ -620,7 +622,8 @@ static ssize_t udp_recvfrom_result(int result, struct udp_recvfrom_s *pstate)
  ****************************************************************************/
 
 #ifdef CONFIG_NETDEV_RSS
-static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
+static void udp_notify_recvcpu(FAR struct net_driver_s *dev,
+                               FAR struct udp_conn_s *conn)
 {
   int cpu;
 
@@ -634,13 +637,13 @@ static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
     {
       if (conn->domain == PF_INET)
         {
-          netdev_notify_recvcpu(conn->dev, cpu, conn->domain,
+          netdev_notify_recvcpu(dev, cpu, conn->domain,
                                 &(conn->u.ipv4.laddr), conn->lport,
                                 &(conn->u.ipv4.raddr), conn->rport);
         }
       else
         {
-          netdev_notify_recvcpu(conn->dev, cpu, conn->domain,
+          netdev_notify_recvcpu(dev, cpu, conn->domain,
                                 &(conn->u.ipv6.laddr), conn->lport,
                                 &(conn->u.ipv6.raddr), conn->rport);
         }
@@ -649,7 +652,7 @@ static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
     }
 }
 #else
-#  define udp_notify_recvcpu(c)
+#  define udp_notify_recvcpu(d,c)
 #endif /* CONFIG_NETDEV_RSS */
 
 /****************************************************************************
@@ -790,7 +793,7 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
     }
 
   conn_dev_unlock(&conn->sconn, dev);
-  udp_notify_recvcpu(conn);
+  udp_notify_recvcpu(dev, conn);
 
   udp_recvfrom_uninitialize(&state);
   return ret;
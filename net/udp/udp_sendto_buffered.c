@@ -261,20 +261,15 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
       return -ENOENT;
     }
 
-  /* Has this address already been bound to a local port (lport)? */
+  /* The local port was bound by udp_connect() before the buffer was
+   * queued.  It cannot be bound here: that takes udp_conn_list_lock(),
+   * which must not be taken with conn_lock() held.
+   */
 
   if (!conn->lport)
     {
-      /* No.. Find an unused local port number and bind it to the
-       * connection structure.
-       */
-
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
-      if (!conn->lport)
-        {
-          nerr("ERROR: Failed to get a local port!\n");
-          return -EADDRINUSE;
-        }
+      nerr("ERROR: Failed to get a local port!\n");
+      return -EADDRINUSE;
     }
 
   /* Get the device that will handle the remote packet transfers.  This
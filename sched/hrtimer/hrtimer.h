@@ -68,9 +68,7 @@
  * being the left-most (minimum) node in the tree.
  */
 
-#ifdef CONFIG_HRTIMER_TREE
 RB_HEAD(hrtimer_tree_s, hrtimer_s);
-#endif
 
 /****************************************************************************
  * Public Data
@@ -80,17 +78,14 @@ RB_HEAD(hrtimer_tree_s, hrtimer_s);
 
 extern seqcount_t g_hrtimer_lock;
 
-#ifdef CONFIG_HRTIMER_TREE
-/* Red-Black tree containing all active high-resolution timers */
+/* Red-Black tree containing all active high-resolution timers.  The
+ * guard timer never expires and keeps the tree non-empty, the head caches
+ * the earliest timer in the tree.
+ */
 
 extern struct hrtimer_tree_s g_hrtimer_tree;
 extern struct hrtimer_s      g_hrtimer_guard;
 extern struct FAR hrtimer_s *g_hrtimer_head;
-#else
-/* List containing all active high-resolution timers */
-
-extern struct list_node g_hrtimer_list;
-#endif
 
 /* Array of pointers to currently running high-resolution timers
  * for each CPU in SMP configurations. Index corresponds to CPU ID.
@@ -193,7 +188,6 @@ static inline_function void hrtimer_reprogram(uint64_t next_expired)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_HRTIMER_TREE
 static inline_function
 int hrtimer_compare(FAR const hrtimer_t *a, FAR const hrtimer_t *b)
 {
@@ -203,7 +197,6 @@ int hrtimer_compare(FAR const hrtimer_t *a, FAR const hrtimer_t *b)
 
   return 1 - (HRTIMER_TIME_BEFORE(a->expired, b->expired) << 1u);
 }
-#endif
 
 /****************************************************************************
  * Red-Black Tree Prototype for high-resolution timers
@@ -214,9 +207,7 @@ int hrtimer_compare(FAR const hrtimer_t *a, FAR const hrtimer_t *b)
  *   operations based on timer expiration time.
  ****************************************************************************/
 
-#ifdef CONFIG_HRTIMER_TREE
 RB_PROTOTYPE(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
-#endif
 
 /****************************************************************************
  * Name: hrtimer_remove
@@ -235,20 +226,18 @@ RB_PROTOTYPE(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
 
 static inline_function bool hrtimer_remove(FAR hrtimer_t *hrtimer)
 {
-  bool is_head;
-#ifdef CONFIG_HRTIMER_TREE
-  is_head = g_hrtimer_head == hrtimer;
+  bool is_head = g_hrtimer_head == hrtimer;
 
-  RB_REMOVE(hrtimer_tree_s, &g_hrtimer_tree, hrtimer);
+  /* The in-order successor of the head is the new minimum.  The guard
+   * timer is never removed, so the head always has a successor.
+   */
 
   if (is_head)
     {
-      g_hrtimer_head = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree);
+      g_hrtimer_head = RB_NEXT(hrtimer_tree_s, &g_hrtimer_tree, hrtimer);
     }
-#else
-  is_head = list_is_head(&g_hrtimer_list, &hrtimer->node);
-  list_delete_fast(&hrtimer->node);
-#endif
+
+  RB_REMOVE(hrtimer_tree_s, &g_hrtimer_tree, hrtimer);
 
   /* Explicitly mark the timer as dequeued. */
 
@@ -274,7 +263,6 @@ static inline_function bool hrtimer_remove(FAR hrtimer_t *hrtimer)
 
 static inline_function bool hrtimer_insert(FAR hrtimer_t *hrtimer)
 {
-#ifdef CONFIG_HRTIMER_TREE
   bool is_head = false;
   RB_INSERT(hrtimer_tree_s, &g_hrtimer_tree, hrtimer);
 
@@ -285,23 +273,6 @@ static inline_function bool hrtimer_insert(FAR hrtimer_t *hrtimer)
     }
 
   return is_head;
-#else
-  FAR hrtimer_t *curr;
-  uint64_t expired = hrtimer->expired;
-
-  list_for_every_entry(&g_hrtimer_list, curr, hrtimer_t, node)
-    {
-      /* Until curr->expired has not timed out relative to expired */
-
-      if (!clock_compare(curr->expired, expired))
-        {
-          break;
-        }
-    }
-
-  list_add_before(&curr->node, &hrtimer->node);
-  return list_is_head(&g_hrtimer_list, &hrtimer->node);
-#endif
 }
 
 /****************************************************************************
@@ -317,11 +288,7 @@ static inline_function bool hrtimer_insert(FAR hrtimer_t *hrtimer)
 
 static inline_function FAR hrtimer_t *hrtimer_get_first(void)
 {
-#ifdef CONFIG_HRTIMER_TREE
   return g_hrtimer_head;
-#else
-  return list_first_entry(&g_hrtimer_list, FAR hrtimer_t, node);
-#endif
 }
 
 /****************************************************************************
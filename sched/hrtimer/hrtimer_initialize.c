@@ -51,36 +51,24 @@ seqcount_t g_hrtimer_lock = SEQLOCK_INITIALIZER;
 
 /* HRTimer queue for all active high-resolution timers.
  *
- * When CONFIG_HRTIMER_TREE is enabled, timers are stored in a queue.
- * When disabled, timers are stored in a linked list.
- *
- * The queue is ordered by absolute expiration time in
- * both configurations.
+ * Timers are stored in a red-black tree ordered by absolute expiration
+ * time.  The guard timer expires last and is never removed, so the tree
+ * and the cached head are never empty.
  */
 
 struct hrtimer_s g_hrtimer_guard =
 {
-#ifdef CONFIG_HRTIMER_TREE
   { NULL },
-#else
-  { &g_hrtimer_list, &g_hrtimer_list },
-#endif
   NULL,
   INT64_MAX
 };
 
-#ifdef CONFIG_HRTIMER_TREE
 struct hrtimer_tree_s g_hrtimer_tree =
 {
   &g_hrtimer_guard
 };
+
 struct FAR hrtimer_s *g_hrtimer_head = &g_hrtimer_guard;
-#else
-struct list_node g_hrtimer_list =
-{
-  &g_hrtimer_guard.node, &g_hrtimer_guard.node
-};
-#endif
 
 /****************************************************************************
  * Public Functions
@@ -97,8 +85,6 @@ struct list_node g_hrtimer_list =
  *   manipulate the hrtimer queue, including insertion,
  *   removal, and lookup operations.
  *
- *   Note: This is only compiled when CONFIG_HRTIMER_TREE is enabled.
- *
  * Assumptions/Notes:
  *   - The tree key is the absolute expiration time stored in
  *     hrtimer_node_s and compared via hrtimer_compare().
@@ -108,6 +94,4 @@ struct list_node g_hrtimer_list =
  *     core (e.g., hrtimer_start(), hrtimer_cancel(), and expire paths).
  ****************************************************************************/
 
-#ifdef CONFIG_HRTIMER_TREE
 RB_GENERATE(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
-#endif
@@ -212,6 +212,15 @@ static inline void nx_workqueues(void)
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+#ifdef CONFIG_SCHED_PCPUWORK
+  /* Start the per-CPU worker threads for work that must run on a given
+   * CPU
+   */
+
+  work_start_pcpu();
+
+#endif /* CONFIG_SCHED_PCPUWORK */
+
 #ifdef CONFIG_LIBC_USRWORK
   /* Start the user-space work queue */
 
@@ -92,8 +92,20 @@
  * task, is always the IDLE task.
  */
 
+#ifdef CONFIG_SCHED_PERCPU_RUNQUEUE
+dq_queue_t g_readytorun[CONFIG_SMP_NCPUS];
+
+#  ifdef CONFIG_SCHED_READYTORUN_BITMAP
+struct prioindex_s g_readytorun_index[CONFIG_SMP_NCPUS];
+#  endif
+#else
 dq_queue_t g_readytorun;
 
+#  ifdef CONFIG_SCHED_READYTORUN_BITMAP
+struct prioindex_s g_readytorun_index;
+#  endif
+#endif
+
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
  *
@@ -131,6 +143,10 @@ FAR struct tcb_s *g_running_tasks[CONFIG_SMP_NCPUS];
 
 #ifndef CONFIG_SMP
 dq_queue_t g_pendingtasks;
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+struct prioindex_s g_pendingtasks_index;
+#endif
 #endif
 
 /* This is the list of all tasks that are blocked waiting for a signal */
@@ -236,8 +252,14 @@ static void tasklist_initialize(void)
 
   /* TSTATE_TASK_READYTORUN */
 
+#ifdef CONFIG_SCHED_PERCPU_RUNQUEUE
+  tlist[TSTATE_TASK_READYTORUN].list = g_readytorun;
+  tlist[TSTATE_TASK_READYTORUN].attr = TLIST_ATTR_PRIORITIZED |
+                                       TLIST_ATTR_INDEXED;
+#else
   tlist[TSTATE_TASK_READYTORUN].list = list_readytorun();
   tlist[TSTATE_TASK_READYTORUN].attr = TLIST_ATTR_PRIORITIZED;
+#endif
 
 #else
 
@@ -405,7 +427,7 @@ static void idle_task_initialize(void)
 #ifdef CONFIG_SMP
       g_assignedtasks[i] = tcb;
 #else
-      dq_addfirst((FAR dq_entry_t *)tcb, TLIST_HEAD(tcb));
+      nxsched_add_prioritized(tcb, TLIST_HEAD(tcb));
 #endif
 
       /* Mark the idle task as the running task */
@@ -31,6 +31,8 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
 #include <sched.h>
 
 #include <nuttx/arch.h>
@@ -52,7 +54,12 @@
  * need to be prioritized).
  */
 
-#define list_readytorun()        (&g_readytorun)
+#ifdef CONFIG_SCHED_PERCPU_RUNQUEUE
+#  define list_readytorun_cpu(cpu) (&g_readytorun[cpu])
+#else
+#  define list_readytorun()        (&g_readytorun)
+#  define list_readytorun_cpu(cpu) list_readytorun()
+#endif
 #ifndef CONFIG_SMP
 #define list_pendingtasks()      (&g_pendingtasks)
 #endif
@@ -74,6 +81,18 @@
 
 #define is_idle_task(t)          ((t)->pid < CONFIG_SMP_NCPUS)
 
+/* Number of ready-to-run queues */
+
+#ifdef CONFIG_SCHED_PERCPU_RUNQUEUE
+#  define NREADYTORUN            CONFIG_SMP_NCPUS
+#else
+#  define NREADYTORUN            1
+#endif
+
+/* Number of 32-bit words in the priority bitmap of a ready-to-run index */
+
+#define PRIOINDEX_NWORDS         ((SCHED_PRIORITY_MAX >> 5) + 1)
+
 /* This macro returns the running task which may different from this_task()
  * during interrupt level context switches.
  */
@@ -133,6 +152,19 @@ struct tasklist_s
   uint8_t attr;          /* List attribute flags */
 };
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* This structure indexes a prioritized task list by priority.  Bit n of
+ * the bitmap is set if the list holds at least one task of priority n, in
+ * which case tail[n] is the last task of that priority in the list.
+ */
+
+struct prioindex_s
+{
+  uint32_t          bitmap[PRIOINDEX_NWORDS];
+  FAR struct tcb_s *tail[SCHED_PRIORITY_MAX + 1];
+};
+#endif
+
 /* This enumeration defines smp schedule task switch rule */
 
 enum task_deliver_e
@@ -165,8 +197,28 @@ enum task_deliver_e
  * task, is always the IDLE task.
  */
 
+#ifdef CONFIG_SCHED_PERCPU_RUNQUEUE
+/* With per-CPU run queues there is one such list for each CPU.  A task in
+ * the list of CPU 'n' always has its cpu field set to 'n'.
+ */
+
+extern dq_queue_t g_readytorun[CONFIG_SMP_NCPUS];
+
+#  ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* Priority index of each g_readytorun list */
+
+extern struct prioindex_s g_readytorun_index[CONFIG_SMP_NCPUS];
+#  endif
+#else
 extern dq_queue_t g_readytorun;
 
+#  ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* Priority index of the g_readytorun list */
+
+extern struct prioindex_s g_readytorun_index;
+#  endif
+#endif
+
 #ifdef CONFIG_SMP
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
@@ -209,6 +261,12 @@ extern struct tcb_s g_idletcb[CONFIG_SMP_NCPUS];
 
 #ifndef CONFIG_SMP
 extern dq_queue_t g_pendingtasks;
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* Priority index of the g_pendingtasks list */
+
+extern struct prioindex_s g_pendingtasks_index;
+#endif
 #endif
 
 /* This is the list of all tasks that are blocked waiting for a signal */
@@ -360,6 +418,15 @@ clock_t nxsched_process_sporadic(FAR struct tcb_s *tcb, clock_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb,
+                            FAR const struct sched_param *param);
+int  nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_resume_deadline(FAR struct tcb_s *tcb);
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb);
+int  nxsched_yield_deadline(FAR struct tcb_s *tcb);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -453,11 +520,165 @@ FAR char **nxsched_get_stackargs(FAR struct tcb_s *tcb);
  * Inline functions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_DEADLINE
+/* Return true if 'tcb' must be queued before 'next', a task of the same
+ * priority.  Deadline tasks are kept in earliest-deadline-first order.
+ */
+
+static inline_function bool nxsched_deadline_before(FAR struct tcb_s *tcb,
+                                                    FAR struct tcb_s *next)
+{
+  return (tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+         (next->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+         !clock_compare(next->deadline->abs_deadline,
+                        tcb->deadline->abs_deadline);
+}
+#else
+#  define nxsched_deadline_before(t, n) false
+#endif
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* Return the priority index of the list, or NULL if it is not indexed. */
+
+static inline_function
+FAR struct prioindex_s *nxsched_prioindex(FAR dq_queue_t *list)
+{
+#ifdef CONFIG_SCHED_PERCPU_RUNQUEUE
+  if (list >= g_readytorun && list < &g_readytorun[CONFIG_SMP_NCPUS])
+    {
+      return &g_readytorun_index[list - g_readytorun];
+    }
+#else
+  if (list == list_readytorun())
+    {
+      return &g_readytorun_index;
+    }
+#endif
+#ifndef CONFIG_SMP
+  else if (list == list_pendingtasks())
+    {
+      return &g_pendingtasks_index;
+    }
+#endif
+
+  return NULL;
+}
+
+/* Return the lowest priority above 'priority' present in the index, or -1
+ * if there is none.
+ */
+
+static inline_function
+int nxsched_prioindex_above(FAR struct prioindex_s *index, int priority)
+{
+  uint32_t bits;
+  int word;
+
+  if (++priority > SCHED_PRIORITY_MAX)
+    {
+      return -1;
+    }
+
+  word = priority >> 5;
+  bits = index->bitmap[word] & (UINT32_MAX << (priority & 31));
+
+  while (bits == 0)
+    {
+      if (++word >= PRIOINDEX_NWORDS)
+        {
+          return -1;
+        }
+
+      bits = index->bitmap[word];
+    }
+
+  return (word << 5) + ffs(bits) - 1;
+}
+
+/* Forget 'tcb' as the last task of its priority, it is about to leave the
+ * indexed list or to change its priority in place.
+ */
+
+static inline_function
+void nxsched_prioindex_remove(FAR struct prioindex_s *index,
+                              FAR struct tcb_s *tcb)
+{
+  uint8_t priority = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+
+  if (index->tail[priority] == tcb)
+    {
+      prev = tcb->blink;
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          index->tail[priority] = prev;
+        }
+      else
+        {
+          index->tail[priority] = NULL;
+          index->bitmap[priority >> 5] &= ~(1u << (priority & 31));
+        }
+    }
+}
+
+/* Insert 'tcb' behind the last task of the same or of the next higher
+ * priority.  Returns true if the tcb was added at the head of the list.
+ */
+
+static inline_function bool nxsched_add_indexed(FAR struct tcb_s *tcb,
+                                                DSEG dq_queue_t *list,
+                                                FAR struct prioindex_s *index)
+{
+  uint8_t sched_priority = tcb->sched_priority;
+  FAR struct tcb_s *prev = index->tail[sched_priority];
+  int above;
+
+  if (prev == NULL)
+    {
+      above = nxsched_prioindex_above(index, sched_priority);
+      prev  = above >= 0 ? index->tail[above] : NULL;
+      index->bitmap[sched_priority >> 5] |= 1u << (sched_priority & 31);
+      index->tail[sched_priority] = tcb;
+    }
+#ifdef CONFIG_SCHED_DEADLINE
+  else if (nxsched_deadline_before(tcb, prev))
+    {
+      /* Walk back to the place of the tcb among the deadline tasks of
+       * its priority.  The tail of the priority does not change.
+       */
+
+      do
+        {
+          prev = prev->blink;
+        }
+      while (prev != NULL && prev->sched_priority == sched_priority &&
+             nxsched_deadline_before(tcb, prev));
+    }
+#endif
+  else
+    {
+      index->tail[sched_priority] = tcb;
+    }
+
+  if (prev == NULL)
+    {
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+      return true;
+    }
+
+  dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb, list);
+  return false;
+}
+#endif
+
 static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
                                                     DSEG dq_queue_t *list)
 {
   FAR struct tcb_s *next;
   FAR struct tcb_s *prev;
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  FAR struct prioindex_s *index = nxsched_prioindex(list);
+#endif
   uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
 
@@ -465,12 +686,23 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
 
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  /* The ready-to-run and pending lists know where the tcb goes */
+
+  if (index != NULL)
+    {
+      return nxsched_add_indexed(tcb, list, index);
+    }
+#endif
+
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in descending sched_priority order.
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && (sched_priority < next->sched_priority ||
+                 (sched_priority == next->sched_priority &&
+                  !nxsched_deadline_before(tcb, next))));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
@@ -532,6 +764,50 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
   return ret;
 }
 
+/* Remove the tcb from a prioritized list */
+
+static inline_function void nxsched_remove_prioritized(FAR struct tcb_s *tcb,
+                                                       DSEG dq_queue_t *list)
+{
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  FAR struct prioindex_s *index = nxsched_prioindex(list);
+
+  if (index != NULL)
+    {
+      nxsched_prioindex_remove(index, tcb);
+    }
+#endif
+
+  dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+/* Change the priority of a running task without moving it.  The caller
+ * must make sure that the task still belongs at the head of the
+ * ready-to-run list with the new priority.
+ */
+
+static inline_function void nxsched_set_running_priority(
+                                        FAR struct tcb_s *tcb,
+                                        int sched_priority)
+{
+#if defined(CONFIG_SCHED_READYTORUN_BITMAP) && !defined(CONFIG_SMP)
+  FAR struct prioindex_s *index = &g_readytorun_index;
+
+  DEBUGASSERT(tcb->task_state == TSTATE_TASK_RUNNING && tcb->blink == NULL);
+
+  nxsched_prioindex_remove(index, tcb);
+  tcb->sched_priority = (uint8_t)sched_priority;
+
+  if (index->tail[sched_priority] == NULL)
+    {
+      index->tail[sched_priority] = tcb;
+      index->bitmap[sched_priority >> 5] |= 1u << (sched_priority & 31);
+    }
+#else
+  tcb->sched_priority = (uint8_t)sched_priority;
+#endif
+}
+
 #  ifdef CONFIG_SMP
 
 /* Try to switch the head of the ready-to-run list to active on "target_cpu".
@@ -606,5 +882,41 @@ static inline_function int nxsched_select_cpu(cpu_set_t affinity)
   DEBUGASSERT(cpu != 0xff);
   return cpu;
 }
+
+/* Return the highest priority ready-to-run task above 'sched_priority' that
+ * is permitted to run on 'cpu', or NULL if there is none.  The run queue of
+ * 'cpu' is searched first so that, at equal priority, a task stays where it
+ * was queued rather than being stolen from another CPU.
+ */
+
+static inline_function FAR struct tcb_s *
+nxsched_find_readytorun(int cpu, int sched_priority)
+{
+  FAR struct tcb_s *found = NULL;
+  FAR struct tcb_s *btcb;
+  int i;
+
+  for (i = 0; i < NREADYTORUN; i++)
+    {
+      FAR dq_queue_t *list = list_readytorun_cpu((cpu + i) % NREADYTORUN);
+
+      for (btcb = (FAR struct tcb_s *)dq_peek(list);
+           btcb != NULL && btcb->sched_priority > sched_priority;
+           btcb = btcb->flink)
+        {
+          /* Is the task permitted to run on this CPU? */
+
+          if (CPU_ISSET(cpu, &btcb->affinity) &&
+              ((btcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || btcb->cpu == cpu))
+            {
+              found          = btcb;
+              sched_priority = btcb->sched_priority;
+              break;
+            }
+        }
+    }
+
+  return found;
+}
 #  endif
 #endif /* __SCHED_SCHED_SCHED_H */
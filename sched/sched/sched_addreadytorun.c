@@ -74,11 +74,14 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * preempted.  NOTE that IRQs disabled implies that pre-emption is
-   * also disabled.
+   * also disabled.  A deadline task of the same priority preempts when its
+   * deadline is earlier, as it is then queued ahead of the current task.
    */
 
   if (nxsched_islocked_tcb(rtcb) &&
-      rtcb->sched_priority < btcb->sched_priority)
+      (rtcb->sched_priority < btcb->sched_priority ||
+       (rtcb->sched_priority == btcb->sched_priority &&
+        nxsched_deadline_before(btcb, rtcb))))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -170,46 +173,56 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
 
   /* If there is a task in readytorun list, which is eglible to run on this
    * CPU, and has higher priority than the current task,
-   * switch the current task to that one.
+   * switch the current task to that one.  TCB_FLAG_CPU_LOCKED may be used
+   * to override affinity.  If the flag is set, assume that btcb->cpu is
+   * valid, and it is the only CPU on which the btcb can run.
    */
 
-  for (btcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
-       btcb && btcb->sched_priority > sched_priority;
-       btcb = btcb->flink)
+  btcb = nxsched_find_readytorun(cpu, sched_priority);
+  if (btcb != NULL)
     {
-      /* Check if the task found in ready-to-run list is allowed to run on
-       * this CPU. TCB_FLAG_CPU_LOCKED may be used to override affinity. If
-       * the flag is set, assume that btcb->cpu is valid, and it is the only
-       * CPU on which the btcb can run.
+      /* Found a task, remove it from ready-to-run list.  With per-CPU run
+       * queues it may be stolen from the queue of another CPU.
        */
 
-      if (CPU_ISSET(cpu, &btcb->affinity) &&
-          ((btcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || btcb->cpu == cpu))
+      nxsched_remove_prioritized(btcb, list_readytorun_cpu(btcb->cpu));
+
+      if (!is_idle_task(rtcb))
         {
-          /* Found a task, remove it from ready-to-run list */
+          /* Put currently running task back to ready-to-run list */
 
-          dq_rem((FAR struct dq_entry_s *)btcb, list_readytorun());
+          rtcb->task_state = TSTATE_TASK_READYTORUN;
+          nxsched_add_prioritized(rtcb, list_readytorun_cpu(cpu));
+        }
+      else
+        {
+          rtcb->task_state = TSTATE_TASK_ASSIGNED;
+        }
 
-          if (!is_idle_task(rtcb))
-            {
-              /* Put currently running task back to ready-to-run list */
+      g_assignedtasks[cpu] = btcb;
+      up_update_task(btcb);
 
-              rtcb->task_state = TSTATE_TASK_READYTORUN;
-              nxsched_add_prioritized(rtcb, list_readytorun());
-            }
-          else
-            {
-              rtcb->task_state = TSTATE_TASK_ASSIGNED;
-            }
+      btcb->cpu = cpu;
+      btcb->task_state = TSTATE_TASK_RUNNING;
+      ret = true;
 
-          g_assignedtasks[cpu] = btcb;
-          up_update_task(btcb);
+#ifdef CONFIG_SCHED_PERCPU_RUNQUEUE
+      /* The preempted task now waits in the queue of this CPU.  If another
+       * CPU is running something less important, let it steal the task.
+       */
+
+      if (!is_idle_task(rtcb) && (rtcb->flags & TCB_FLAG_CPU_LOCKED) == 0)
+        {
+          int target_cpu = nxsched_select_cpu(rtcb->affinity);
 
-          btcb->cpu = cpu;
-          btcb->task_state = TSTATE_TASK_RUNNING;
-          ret = true;
-          break;
+          if (target_cpu != cpu &&
+              current_task(target_cpu)->sched_priority <
+              rtcb->sched_priority)
+            {
+              nxsched_deliver_task(cpu, target_cpu, SWITCH_HIGHER);
+            }
         }
+#endif
     }
 
   return ret;
@@ -261,12 +274,14 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
    * CPU
    */
 
-  btcb->task_state = TSTATE_TASK_READYTORUN;
-  nxsched_add_prioritized(btcb, list_readytorun());
-
-  /* In some cases, such as setaffinity, cpu need to be used. */
+  /* In some cases, such as setaffinity, cpu need to be used.  It also
+   * selects the run queue of the target CPU when there is one per CPU.
+   */
 
   btcb->cpu = target_cpu;
+  btcb->task_state = TSTATE_TASK_READYTORUN;
+  nxsched_add_prioritized(btcb, list_readytorun_cpu(target_cpu));
+
   if (tcb->sched_priority < btcb->sched_priority)
     {
       doswitch = nxsched_deliver_task(this_cpu(), target_cpu,
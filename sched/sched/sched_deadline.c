@@ -0,0 +1,538 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <nuttx/debug.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Admission control works on the utilization of the reservations in parts
+ * per million.
+ */
+
+#define DEADLINE_UTIL_SCALE 1000000
+#define DEADLINE_UTIL_MAX   (CONFIG_SCHED_DEADLINE_MAXUTIL * \
+                             (DEADLINE_UTIL_SCALE / 100))
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void deadline_timer_expire(wdparm_t arg);
+static void deadline_budget_expire(wdparm_t arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Sum of the utilization of all deadline reservations */
+
+static uint32_t g_deadline_util;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_set_priority
+ *
+ * Description:
+ *   Move the thread to a new priority.  Setting the same priority again
+ *   re-queues the thread at its place in EDF order.
+ *
+ * Input Parameters:
+ *   tcb      - TCB of task whose priority will be modified
+ *   priority - The new priority
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_set_priority(FAR struct tcb_s *tcb, int priority)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* If the priority was boosted above the new priority, then just reset
+   * the base priority and continue to run at the boosted priority.
+   */
+
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority > priority)
+    {
+      tcb->base_priority = priority;
+      return;
+    }
+#endif
+
+  DEBUGVERIFY(nxsched_reprioritize(tcb, priority));
+}
+
+/****************************************************************************
+ * Name: deadline_runnable
+ *
+ * Description:
+ *   Return true if the thread still has work to do in its current job.  A
+ *   thread that yielded or blocked waiting for its next input is done.
+ *
+ ****************************************************************************/
+
+static inline bool deadline_runnable(FAR struct tcb_s *tcb)
+{
+  return tcb->task_state == TSTATE_TASK_RUNNING ||
+         tcb->task_state == TSTATE_TASK_READYTORUN ||
+         tcb->task_state == TSTATE_TASK_PENDING;
+}
+
+/****************************************************************************
+ * Name: deadline_release
+ *
+ * Description:
+ *   Release the next job of the thread:  Advance the release time and the
+ *   absolute deadline, replenish the budget and restore the priority of a
+ *   throttled thread.
+ *
+ * Input Parameters:
+ *   tcb - TCB of the deadline thread
+ *   now - The current time
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_release(FAR struct tcb_s *tcb, clock_t now)
+{
+  FAR struct deadline_s *deadline = tcb->deadline;
+
+  /* Do not try to catch up with periods lost to a late timer */
+
+  deadline->release += deadline->period;
+  if (!clock_compare(now, deadline->release + deadline->period))
+    {
+      deadline->release = now;
+    }
+
+  deadline->abs_deadline = deadline->release + deadline->deadline;
+  deadline->budget       = deadline->runtime;
+  deadline->eventtime    = now;
+  deadline->flags        = 0;
+
+  /* Re-queue the thread in EDF order at its high priority */
+
+  deadline_set_priority(tcb, deadline->hi_priority);
+
+  /* A thread that kept the CPU starts to consume the new budget now */
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      wd_start(&deadline->budget_timer, deadline->budget,
+               deadline_budget_expire, (wdparm_t)tcb);
+    }
+}
+
+/****************************************************************************
+ * Name: deadline_timer_expire
+ *
+ * Description:
+ *   Handles the deadline of the current job and the release of the next
+ *   one.  A deadline is missed if the thread is still runnable when it
+ *   expires.
+ *
+ * Input Parameters:
+ *   arg - The TCB of the deadline thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_timer_expire(wdparm_t arg)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg;
+  FAR struct deadline_s *deadline;
+  clock_t next;
+  clock_t now;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+  now      = clock_systime_ticks();
+
+  /* Check the deadline of the current job */
+
+  if ((deadline->flags & DEADLINE_FLAG_CHECKED) == 0 &&
+      clock_compare(deadline->abs_deadline, now))
+    {
+      deadline->flags |= DEADLINE_FLAG_CHECKED;
+      if (deadline_runnable(tcb))
+        {
+          deadline->nmisses++;
+        }
+    }
+
+  /* Then release the next job if its period started */
+
+  next = deadline->release + deadline->period;
+  if (clock_compare(next, now))
+    {
+      deadline_release(tcb, now);
+      next = deadline->release + deadline->period;
+    }
+
+  /* Wake up at the next deadline, or at the next release if the deadline
+   * of this job was already checked.
+   */
+
+  if ((deadline->flags & DEADLINE_FLAG_CHECKED) == 0)
+    {
+      next = deadline->abs_deadline;
+    }
+
+  wd_start_abstick(&deadline->timer, next, deadline_timer_expire, arg);
+}
+
+/****************************************************************************
+ * Name: deadline_budget_expire
+ *
+ * Description:
+ *   The running thread exhausted the budget of its current job.  Throttle
+ *   it to the lowest priority until the next release.
+ *
+ * Input Parameters:
+ *   arg - The TCB of the deadline thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_budget_expire(wdparm_t arg)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg;
+  FAR struct deadline_s *deadline;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  deadline->budget = 0;
+  deadline->flags |= DEADLINE_FLAG_THROTTLED;
+
+  deadline_set_priority(tcb, SCHED_PRIORITY_MIN);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Establish (or change) the deadline reservation of a thread and release
+ *   its first job now.  This function is called from sched_setscheduler()
+ *   and sched_setparam().  The caller is responsible for setting the
+ *   thread priority to param->sched_priority afterwards.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - The new runtime/deadline/period and priority.  A zero period
+ *           defaults to the deadline.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *     EINVAL  The reservation does not satisfy
+ *             0 < runtime <= deadline <= period
+ *     EBUSY   Admission control refused the reservation
+ *     ENOMEM  Out of memory
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb,
+                           FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *deadline;
+  irqstate_t flags;
+  clock_t runtime;
+  clock_t relative;
+  clock_t period;
+  clock_t now;
+  uint32_t reserved;
+  uint32_t util;
+
+  DEBUGASSERT(tcb != NULL && param != NULL);
+
+  /* Convert timespec values to system clock ticks */
+
+  runtime  = clock_time2ticks(&param->sched_dl_runtime);
+  relative = clock_time2ticks(&param->sched_dl_deadline);
+  period   = clock_time2ticks(&param->sched_dl_period);
+
+  if (period == 0)
+    {
+      period = relative;
+    }
+
+  if (runtime < 1 || runtime > relative || relative > period)
+    {
+      return -EINVAL;
+    }
+
+  util = (uint32_t)((uint64_t)runtime * DEADLINE_UTIL_SCALE / period);
+
+  /* Allocate the deadline add-on the first time around */
+
+  deadline = tcb->deadline;
+  if (deadline == NULL)
+    {
+      deadline = kmm_zalloc(sizeof(struct deadline_s));
+      if (deadline == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          return -ENOMEM;
+        }
+    }
+
+  flags = enter_critical_section();
+
+  /* Admission control:  The utilization of all reservations may not exceed
+   * the configured limit.
+   */
+
+  reserved = g_deadline_util;
+  if (tcb->deadline != NULL)
+    {
+      reserved -= deadline->util;
+    }
+
+  if (reserved + util > DEADLINE_UTIL_MAX)
+    {
+      leave_critical_section(flags);
+      if (tcb->deadline == NULL)
+        {
+          kmm_free(deadline);
+        }
+
+      return -EBUSY;
+    }
+
+  g_deadline_util = reserved + util;
+
+  /* Stop the current job, if any */
+
+  wd_cancel(&deadline->timer);
+  wd_cancel(&deadline->budget_timer);
+
+  /* Save the reservation and release the first job */
+
+  now                    = clock_systime_ticks();
+  deadline->hi_priority  = param->sched_priority;
+  deadline->flags        = 0;
+  deadline->runtime      = runtime;
+  deadline->deadline     = relative;
+  deadline->period       = period;
+  deadline->release      = now;
+  deadline->abs_deadline = now + relative;
+  deadline->budget       = runtime;
+  deadline->eventtime    = now;
+  deadline->util         = util;
+
+  tcb->deadline          = deadline;
+  tcb->flags             = (tcb->flags & ~TCB_FLAG_POLICY_MASK) |
+                           TCB_FLAG_SCHED_DEADLINE;
+
+  wd_start_abstick(&deadline->timer, deadline->abs_deadline,
+                   deadline_timer_expire, (wdparm_t)tcb);
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      wd_start(&deadline->budget_timer, runtime,
+               deadline_budget_expire, (wdparm_t)tcb);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Called to terminate deadline scheduling on a given thread, to release
+ *   its reservation and to free all resources associated with the policy.
+ *   This function is called when the thread exits or when it is changed
+ *   to another policy via sched_setscheduler().  The thread is left with
+ *   the FIFO policy.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is ending deadline scheduling.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline;
+  irqstate_t flags;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  flags = enter_critical_section();
+
+  wd_cancel(&deadline->timer);
+  wd_cancel(&deadline->budget_timer);
+
+  g_deadline_util -= deadline->util;
+
+  tcb->flags    &= ~TCB_FLAG_POLICY_MASK;
+  tcb->deadline  = NULL;
+
+  leave_critical_section(flags);
+
+  kmm_free(deadline);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_deadline
+ *
+ * Description:
+ *   Called when a deadline thread is resumed to start consuming the budget
+ *   of its current job.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is being resumed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+void nxsched_resume_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  deadline->eventtime = clock_systime_ticks();
+  if ((deadline->flags & DEADLINE_FLAG_THROTTLED) == 0)
+    {
+      wd_start(&deadline->budget_timer, deadline->budget,
+               deadline_budget_expire, (wdparm_t)tcb);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_deadline
+ *
+ * Description:
+ *   Called when a deadline thread is suspended to charge the time it ran
+ *   to the budget of its current job.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is being suspended.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline;
+  clock_t elapsed;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  wd_cancel(&deadline->budget_timer);
+  if ((deadline->flags & DEADLINE_FLAG_THROTTLED) == 0)
+    {
+      elapsed = clock_systime_ticks() - deadline->eventtime;
+      deadline->budget = elapsed < deadline->budget ?
+                         deadline->budget - elapsed : 0;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_yield_deadline
+ *
+ * Description:
+ *   Called from sched_yield() when the current job of a deadline thread is
+ *   complete.  The thread sleeps until the release of its next job.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the running thread.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxsched_yield_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline;
+  irqstate_t flags;
+
+  DEBUGASSERT(tcb == this_task() && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  flags = enter_critical_section();
+  nxsched_abstick_sleep(deadline->release + deadline->period);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -36,6 +36,75 @@
 #include "clock/clock.h"
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_copy_param
+ *
+ * Description:
+ *   Return the scheduling parameters of the task, including those of its
+ *   policy.
+ *
+ ****************************************************************************/
+
+static void nxsched_copy_param(FAR struct tcb_s *tcb,
+                               FAR struct sched_param *param)
+{
+  /* Return the priority of the task */
+
+  param->sched_priority = (int)tcb->sched_priority;
+
+#ifdef CONFIG_SCHED_SPORADIC
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+    {
+      FAR struct sporadic_s *sporadic = tcb->sporadic;
+      DEBUGASSERT(sporadic != NULL);
+
+      /* Return parameters associated with SCHED_SPORADIC */
+
+      param->sched_ss_low_priority = (int)sporadic->low_priority;
+      param->sched_ss_max_repl     = (int)sporadic->max_repl;
+
+      clock_ticks2time(&param->sched_ss_repl_period, sporadic->repl_period);
+      clock_ticks2time(&param->sched_ss_init_budget, sporadic->budget);
+    }
+  else
+    {
+      param->sched_ss_low_priority        = 0;
+      param->sched_ss_max_repl            = 0;
+      param->sched_ss_repl_period.tv_sec  = 0;
+      param->sched_ss_repl_period.tv_nsec = 0;
+      param->sched_ss_init_budget.tv_sec  = 0;
+      param->sched_ss_init_budget.tv_nsec = 0;
+    }
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      FAR struct deadline_s *deadline = tcb->deadline;
+      DEBUGASSERT(deadline != NULL);
+
+      /* Return parameters associated with SCHED_DEADLINE */
+
+      clock_ticks2time(&param->sched_dl_runtime, deadline->runtime);
+      clock_ticks2time(&param->sched_dl_deadline, deadline->deadline);
+      clock_ticks2time(&param->sched_dl_period, deadline->period);
+    }
+  else
+    {
+      param->sched_dl_runtime.tv_sec   = 0;
+      param->sched_dl_runtime.tv_nsec  = 0;
+      param->sched_dl_deadline.tv_sec  = 0;
+      param->sched_dl_deadline.tv_nsec = 0;
+      param->sched_dl_period.tv_sec    = 0;
+      param->sched_dl_period.tv_nsec   = 0;
+    }
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -86,9 +155,9 @@ int nxsched_get_param(pid_t pid, FAR struct sched_param *param)
       rtcb = this_task();
       if (pid == 0 || pid == rtcb->pid)
         {
-          /* Return the priority if the calling task. */
+          /* Return the parameters of the calling task. */
 
-          param->sched_priority = (int)rtcb->sched_priority;
+          nxsched_copy_param(rtcb, param);
         }
 
       /* This PID is not for the calling task, we will have to look it up */
@@ -107,37 +176,7 @@ int nxsched_get_param(pid_t pid, FAR struct sched_param *param)
             }
           else
             {
-              /* Return the priority of the task */
-
-              param->sched_priority = (int)tcb->sched_priority;
-
-#ifdef CONFIG_SCHED_SPORADIC
-              if ((tcb->flags & TCB_FLAG_POLICY_MASK) ==
-                  TCB_FLAG_SCHED_SPORADIC)
-                {
-                  FAR struct sporadic_s *sporadic = tcb->sporadic;
-                  DEBUGASSERT(sporadic != NULL);
-
-                  /* Return parameters associated with SCHED_SPORADIC */
-
-                  param->sched_ss_low_priority = (int)sporadic->low_priority;
-                  param->sched_ss_max_repl     = (int)sporadic->max_repl;
-
-                  clock_ticks2time(&param->sched_ss_repl_period,
-                                  sporadic->repl_period);
-                  clock_ticks2time(&param->sched_ss_init_budget,
-                                  sporadic->budget);
-                }
-              else
-                {
-                  param->sched_ss_low_priority        = 0;
-                  param->sched_ss_max_repl            = 0;
-                  param->sched_ss_repl_period.tv_sec  = 0;
-                  param->sched_ss_repl_period.tv_nsec = 0;
-                  param->sched_ss_init_budget.tv_sec  = 0;
-                  param->sched_ss_init_budget.tv_nsec = 0;
-                }
-#endif
+              nxsched_copy_param(tcb, param);
             }
 
           leave_critical_section(flags);
@@ -64,9 +64,11 @@
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
+#ifndef CONFIG_SCHED_READYTORUN_BITMAP
   FAR struct tcb_s *pnext;
-  FAR struct tcb_s *rtcb;
   FAR struct tcb_s *rprev;
+#endif
+  FAR struct tcb_s *rtcb;
   bool ret = false;
 
   /* Initialize the inner search loop */
@@ -80,6 +82,31 @@ bool nxsched_merge_pending(void)
 
   if (!nxsched_islocked_tcb(rtcb))
     {
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      /* The priority index finds the place of each pending task in the
+       * ready-to-run list directly.
+       */
+
+      while ((ptcb = (FAR struct tcb_s *)
+                     dq_peek(list_pendingtasks())) != NULL)
+        {
+          nxsched_remove_prioritized(ptcb, list_pendingtasks());
+
+          if (nxsched_add_prioritized(ptcb, list_readytorun()))
+            {
+              /* ptcb was added at the head of the ready-to-run list */
+
+              ptcb->flink->task_state = TSTATE_TASK_READYTORUN;
+              ptcb->task_state        = TSTATE_TASK_RUNNING;
+              up_update_task(ptcb);
+              ret                     = true;
+            }
+          else
+            {
+              ptcb->task_state        = TSTATE_TASK_READYTORUN;
+            }
+        }
+#else
       for (ptcb = (FAR struct tcb_s *)list_pendingtasks()->head;
            ptcb;
            ptcb = pnext)
@@ -92,11 +119,13 @@ bool nxsched_merge_pending(void)
 
           /* Search the ready-to-run list to find the location to insert the
            * new ptcb. Each is list is maintained in ascending sched_priority
-           * order.
+           * order, and deadline order among deadline tasks of a priority.
            */
 
           for (;
-               (ptcb->sched_priority <= rtcb->sched_priority);
+               (ptcb->sched_priority < rtcb->sched_priority ||
+                (ptcb->sched_priority == rtcb->sched_priority &&
+                 !nxsched_deadline_before(ptcb, rtcb)));
                rtcb = rtcb->flink)
             {
             }
@@ -146,6 +175,7 @@ bool nxsched_merge_pending(void)
 
       list_pendingtasks()->head = NULL;
       list_pendingtasks()->tail = NULL;
+#endif
     }
 
   return ret;
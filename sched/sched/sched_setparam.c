@@ -139,6 +139,24 @@ int set_sporadic_param(FAR const struct sched_param *param,
 #  define set_sporadic_param(p, r, t) OK
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+static inline_function
+int set_deadline_param(FAR const struct sched_param *param,
+                       FAR struct tcb_s *tcb)
+{
+  /* Update the reservation of a SCHED_DEADLINE thread */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      return nxsched_start_deadline(tcb, param);
+    }
+
+  return OK;
+}
+#else
+#  define set_deadline_param(p, t) OK
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -219,6 +237,11 @@ int nxsched_set_param(pid_t pid, FAR const struct sched_param *param)
           ret = set_sporadic_param(param, rtcb, tcb);
         }
 
+      if (ret >= 0)
+        {
+          ret = set_deadline_param(param, tcb);
+        }
+
       /* Then perform the reprioritization */
 
       if (ret >= 0)
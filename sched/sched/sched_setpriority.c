@@ -70,7 +70,9 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
   /* Get the TCB of the next highest priority, ready to run task */
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SCHED_PERCPU_RUNQUEUE)
+  nxttcb = nxsched_find_readytorun(tcb->cpu, SCHED_PRIORITY_MIN - 1);
+#elif defined(CONFIG_SMP)
   nxttcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
 #else
   nxttcb = tcb->flink;
@@ -120,7 +122,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
-          tcb->sched_priority = (uint8_t)sched_priority;
+          nxsched_set_running_priority(tcb, sched_priority);
         }
       else
         {
@@ -140,7 +142,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
-      tcb->sched_priority = (uint8_t)sched_priority;
+      nxsched_set_running_priority(tcb, sched_priority);
     }
 }
 
@@ -169,7 +171,7 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
   rtcb = this_task();
 
 #ifdef CONFIG_SMP
-  dq_rem((FAR struct dq_entry_s *)tcb, list_readytorun());
+  nxsched_remove_prioritized(tcb, list_readytorun_cpu(tcb->cpu));
   tcb->sched_priority = sched_priority;
   if (nxsched_add_readytorun(tcb))
 #else
@@ -209,7 +211,7 @@ static inline void nxsched_blocked_setpriority(FAR struct tcb_s *tcb,
     {
       /* Remove the TCB from the prioritized task list */
 
-      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+      nxsched_remove_prioritized(tcb, tasklist);
 
       /* Change the task priority */
 
@@ -161,6 +161,7 @@ int process_sporadic(FAR struct tcb_s *tcb,
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  A SCHED_DEADLINE reservation was refused by admission control.
  *
  ****************************************************************************/
 
@@ -169,6 +170,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
+  uint16_t oldpolicy;
+#endif
   int ret = -EINVAL;
 
   /* Check if the task to modify the calling task */
@@ -200,35 +204,70 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
            || policy == SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+           || policy == SCHED_DEADLINE
 #endif
            || policy == SCHED_FIFO) &&
           param->sched_priority >= SCHED_PRIORITY_MIN &&
           param->sched_priority <= SCHED_PRIORITY_MAX)
         {
           ret = OK;
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
+          oldpolicy = tcb->flags & TCB_FLAG_POLICY_MASK;
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+          /* Admission control of a deadline reservation comes first, so
+           * that a refused one leaves the current policy in place.  It
+           * allocates the reservation, so it is not done in the critical
+           * section below, and sets the deadline policy on success.
+           */
+
+          if (policy == SCHED_DEADLINE)
+            {
+              ret = nxsched_start_deadline(tcb, param);
+              if (ret < 0)
+                {
+                  goto errout;
+                }
+            }
+#endif
 
           /* Further, disable timer interrupts
            * while we set up scheduling policy.
            */
 
           flags = enter_critical_section();
-          tcb->flags &= ~TCB_FLAG_POLICY_MASK;
 
-          switch (policy)
-            {
-              case SCHED_FIFO:
+          /* Stop the old policy when changing it */
+
 #ifdef CONFIG_SCHED_SPORADIC
-                /* Cancel any on-going sporadic scheduling */
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC &&
+              policy != SCHED_SPORADIC)
+            {
+              DEBUGVERIFY(nxsched_stop_sporadic(tcb));
+            }
+#endif
 
-                if ((tcb->flags & TCB_FLAG_POLICY_MASK) ==
-                    TCB_FLAG_SCHED_SPORADIC)
-                  {
-                    DEBUGVERIFY(nxsched_stop_sporadic(tcb));
-                  }
+#ifdef CONFIG_SCHED_DEADLINE
+          if (oldpolicy == TCB_FLAG_SCHED_DEADLINE &&
+              policy != SCHED_DEADLINE)
+            {
+              DEBUGVERIFY(nxsched_stop_deadline(tcb));
+            }
 #endif
 
+          switch (policy)
+            {
+#if CONFIG_RR_INTERVAL == 0
+              case SCHED_OTHER:
+#endif
+              case SCHED_FIFO:
+
                 /* Save the FIFO scheduling parameters */
 
+                tcb->flags     &= ~TCB_FLAG_POLICY_MASK;
                 tcb->flags     |= TCB_FLAG_SCHED_FIFO;
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
                 tcb->timeslice  = 0;
@@ -238,18 +277,10 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #if CONFIG_RR_INTERVAL > 0
               case SCHED_OTHER:
               case SCHED_RR:
-#  ifdef CONFIG_SCHED_SPORADIC
-                /* Cancel any on-going sporadic scheduling */
-
-                if ((tcb->flags & TCB_FLAG_POLICY_MASK) ==
-                    TCB_FLAG_SCHED_SPORADIC)
-                  {
-                    DEBUGVERIFY(nxsched_stop_sporadic(tcb));
-                  }
-#  endif
 
                 /* Save the round robin scheduling parameters */
 
+                tcb->flags     &= ~TCB_FLAG_POLICY_MASK;
                 tcb->flags     |= TCB_FLAG_SCHED_RR;
                 tcb->timeslice  = MSEC2TICK(CONFIG_RR_INTERVAL);
                 break;
@@ -257,9 +288,25 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 
 #ifdef CONFIG_SCHED_SPORADIC
               case SCHED_SPORADIC:
+
+                /* A thread that is sporadic already only gets its
+                 * parameters reset.
+                 */
+
+                if (oldpolicy != TCB_FLAG_SCHED_SPORADIC)
+                  {
+                    tcb->flags &= ~TCB_FLAG_POLICY_MASK;
+                  }
+
                 ret = process_sporadic(tcb, param);
                 break;
 #endif
+
+              default:
+
+                /* SCHED_DEADLINE was set up above */
+
+                break;
             }
 
           leave_critical_section(flags);
@@ -277,6 +324,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
       ret = nxsched_reprioritize(tcb, param->sched_priority);
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+errout:
+#endif
   sched_unlock();
   return ret;
 }
@@ -307,6 +357,7 @@ int nxsched_set_scheduler(pid_t pid, int policy,
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  A SCHED_DEADLINE reservation was refused by admission control.
  *
  ****************************************************************************/
 
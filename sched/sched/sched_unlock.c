@@ -90,7 +90,11 @@ void sched_unlock(void)
            */
 
 #ifdef CONFIG_SMP
+#  ifdef CONFIG_SCHED_PERCPU_RUNQUEUE
+          ptcb = nxsched_find_readytorun(rtcb->cpu, rtcb->sched_priority);
+#  else
           ptcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
+#  endif
           if (ptcb && ptcb->sched_priority > rtcb->sched_priority &&
               nxsched_deliver_task(rtcb->cpu, rtcb->cpu, SWITCH_HIGHER))
 #else
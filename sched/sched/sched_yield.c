@@ -39,7 +39,8 @@
  *
  * Description:
  *   This function forces the calling task to give up the CPU (only to other
- *   tasks at the same priority).
+ *   tasks at the same priority).  A SCHED_DEADLINE task completes its
+ *   current job and sleeps until the start of its next period.
  *
  * Input Parameters:
  *   None
@@ -56,6 +57,18 @@ int sched_yield(void)
   FAR struct tcb_s *rtcb = this_task();
   int ret;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline task yields the rest of its job and sleeps until the next
+   * period.
+   */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      ret = nxsched_yield_deadline(rtcb);
+      return ret < 0 ? ERROR : OK;
+    }
+#endif
+
   /* This equivalent to just resetting the task priority to its current value
    * since this will cause the task to be rescheduled behind any other tasks
    * at the same priority.
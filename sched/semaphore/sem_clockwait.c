@@ -46,7 +46,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nxsem_clockwait
+ * Name: nxsem_clockwait_slow
  *
  * Description:
  *   This function will lock the semaphore referenced by sem as in the
@@ -89,8 +89,8 @@
  *
  ****************************************************************************/
 
-int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
-                    FAR const struct timespec *abstime)
+int nxsem_clockwait_slow(FAR sem_t *sem, clockid_t clockid,
+                         FAR const struct timespec *abstime)
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
@@ -99,23 +99,27 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
   DEBUGASSERT(sem != NULL && abstime != NULL);
   DEBUGASSERT(up_interrupt_context() == false);
 
-  /* We will disable interrupts until we have completed the semaphore
-   * wait.  We need to do this (as opposed to just disabling pre-emption)
-   * because there could be interrupt handlers that are asynchronously
-   * posting semaphores and to prevent race conditions with watchdog
-   * timeout.  This is not too bad because interrupts will be re-
-   * enabled while we are blocked waiting for the semaphore.
-   */
-
   if (abstime->tv_nsec >= 0 && abstime->tv_nsec < 1000000000)
     {
-      flags = enter_critical_section();
-
-      /* Try to take the semaphore without waiting. */
+      /* Try to take the semaphore without waiting.  The uncontended case
+       * is handled by the atomic fast path and does not need the critical
+       * section.
+       */
 
       ret = nxsem_trywait(sem);
       if (ret != OK)
         {
+          /* We will disable interrupts until we have completed the
+           * semaphore wait.  We need to do this (as opposed to just
+           * disabling pre-emption) because there could be interrupt
+           * handlers that are asynchronously posting semaphores and to
+           * prevent race conditions with watchdog timeout.  This is not
+           * too bad because interrupts will be re-enabled while we are
+           * blocked waiting for the semaphore.
+           */
+
+          flags = enter_critical_section();
+
           /* We will have to wait for the semaphore.  Make sure that
            * we were provided with a valid timeout.
            */
@@ -140,11 +144,11 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
           /* Stop the watchdog timer */
 
           wd_cancel(&rtcb->waitdog);
-        }
 
-      /* We can now restore interrupts and delete the watchdog */
+          /* We can now restore interrupts and delete the watchdog */
 
-      leave_critical_section(flags);
+          leave_critical_section(flags);
+        }
     }
 
   return ret;
@@ -46,7 +46,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nxsem_tickwait
+ * Name: nxsem_tickwait_slow
  *
  * Description:
  *   This function is a lighter weight version of sem_timedwait().  It is
@@ -66,30 +66,23 @@
  *
  ****************************************************************************/
 
-int nxsem_tickwait(FAR sem_t *sem, uint32_t delay)
+int nxsem_tickwait_slow(FAR sem_t *sem, uint32_t delay)
 {
   FAR struct tcb_s *rtcb;
   irqstate_t flags;
   int ret;
 
-  /* We will disable interrupts until we have completed the semaphore
-   * wait.  We need to do this (as opposed to just disabling pre-emption)
-   * because there could be interrupt handlers that are asynchronously
-   * posting semaphores and to prevent race conditions with watchdog
-   * timeout.  This is not too bad because interrupts will be re-
-   * enabled while we are blocked waiting for the semaphore.
+  /* Try to take the semaphore without waiting.  The uncontended case is
+   * handled by the atomic fast path and does not need the critical
+   * section.
    */
 
-  flags = enter_critical_section();
-
-  /* Try to take the semaphore without waiting. */
-
   ret = nxsem_trywait(sem);
   if (ret == OK)
     {
       /* We got it! */
 
-      goto out;
+      return ret;
     }
 
   /* We will have to wait for the semaphore.  Make sure that we were provided
@@ -100,10 +93,21 @@ int nxsem_tickwait(FAR sem_t *sem, uint32_t delay)
     {
       /* Timed out already before waiting */
 
-      ret = -ETIMEDOUT;
-      goto out;
+      return -ETIMEDOUT;
     }
 
+  /* We will disable interrupts until we have completed the semaphore
+   * wait.  We need to do this (as opposed to just disabling pre-emption)
+   * because there could be interrupt handlers that are asynchronously
+   * posting semaphores and to prevent race conditions with watchdog
+   * timeout.  This is not too bad because interrupts will be re-
+   * enabled while we are blocked waiting for the semaphore.  The
+   * semaphore may have been posted since the attempt above, in which
+   * case nxsem_wait() returns immediately.
+   */
+
+  flags = enter_critical_section();
+
   rtcb = this_task();
 
   /* Start the watchdog with interrupts still disabled */
@@ -120,7 +124,6 @@ int nxsem_tickwait(FAR sem_t *sem, uint32_t delay)
 
   /* We can now restore interrupts */
 
-out:
   leave_critical_section(flags);
   return ret;
 }
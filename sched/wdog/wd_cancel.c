@@ -38,6 +38,46 @@
 #include "sched/sched.h"
 #include "wdog/wdog.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wait_running
+ *
+ * Description:
+ *   Wait for the function of the watchdog to return if another CPU is
+ *   running it.  The watchdog functions run without the watchdog lock, a
+ *   caller which frees the argument of the watchdog after wd_cancel() must
+ *   not race with them.  The CPU running wd_cancel() is skipped: it is the
+ *   watchdog function itself, or an interrupt nested in it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static void wd_wait_running(FAR struct wdog_s *wdog)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu == this_cpu())
+        {
+          continue;
+        }
+
+      while (g_wdrunning[cpu] == wdog)
+        {
+          UP_DSB();
+        }
+    }
+
+  UP_DMB();
+}
+#else
+#  define wd_wait_running(wdog)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -47,7 +87,9 @@
  *
  * Description:
  *   This function cancels a currently running watchdog timer. Watchdog
- *   timers may be canceled from the interrupt level.
+ *   timers may be canceled from the interrupt level.  If the function of
+ *   the watchdog is running on another CPU, wd_cancel() returns once it
+ *   has returned.
  *
  * Input Parameters:
  *   wdog - ID of the watchdog to cancel.
@@ -60,7 +102,11 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  clock_t            next;
+#else
   FAR struct wdog_s *first;
+#endif
   irqstate_t         flags;
   int                  ret = -EINVAL;
 
@@ -70,30 +116,39 @@ int wd_cancel(FAR struct wdog_s *wdog)
        * cancellation is complete
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave(&g_wdspinlock);
 
       /* Make sure that the watchdog is valid and still active. */
 
       if (WDOG_ISACTIVE(wdog))
         {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+          next = wd_next_expire();
+#else
           first = list_first_entry(&g_wdactivelist, struct wdog_s, node);
+#endif
 
           /* Now, remove the watchdog from the timer queue */
 
-          list_delete_fast(&wdog->node);
+          wd_remove(wdog);
 
           /* Mark the watchdog inactive */
 
           wdog->func = NULL;
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+          if ((wd_list_is_empty() || wd_next_expire() != next) &&
+              !wd_in_callback())
+#else
           if (first == wdog && !wd_in_callback())
+#endif
             {
               /* If the watchdog is at the head of the timer queue, then
                * we will need to re-adjust the interval timer that will
                * generate the next interval event.
                */
 
-              if (!list_is_empty(&g_wdactivelist))
+              if (!wd_list_is_empty())
                 {
                   wd_timer_start(wd_next_expire(), false);
                 }
@@ -106,7 +161,12 @@ int wd_cancel(FAR struct wdog_s *wdog)
           ret = OK;
         }
 
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_wdspinlock, flags);
+
+      /* Wait without the lock, the watchdog function may take it */
+
+      wd_wait_running(wdog);
+
       sched_note_wdog(NOTE_WDOG_CANCEL, (FAR void *)wdog->func,
                       (FAR void *)(uintptr_t)wdog->expired);
     }
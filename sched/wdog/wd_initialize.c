@@ -39,7 +39,15 @@
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
+
+spinlock_t g_wdspinlock = SP_UNLOCKED;
+
+#ifdef CONFIG_SMP
+FAR struct wdog_s *volatile g_wdrunning[CONFIG_SMP_NCPUS];
+#endif
 
 #ifdef CONFIG_HRTIMER
 struct hrtimer_s g_wdtimer;
@@ -111,55 +111,73 @@ static inline_function clock_t wd_expiration(clock_t ticks)
   wdentry_t          func;
   wdparm_t           arg;
   clock_t     next_ticks = ticks;
+  bool        csection   = false;
 
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave(&g_wdspinlock);
 
   wd_update_expire(ticks);
 
-  wd_set_nested(true);
-
-  /* Process the watchdog at the head of the list as well as any
-   * other watchdogs that became ready to run at this time
+  /* The watchdog functions still run inside the critical section, so that
+   * a caller holding it can not race with the expiration of a watchdog it
+   * is about to cancel.  Only enter it if there is something to run, and
+   * before the watchdog lock to respect the lock ordering.
    */
 
-  while (!list_is_empty(&g_wdactivelist))
+  if (wd_has_expired(ticks))
     {
-      wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
+      spin_unlock_irqrestore(&g_wdspinlock, flags);
+      flags = enter_critical_section();
+      spin_lock(&g_wdspinlock);
+      csection = true;
+
+      wd_set_nested(true);
 
-      /* Check if watchdog has expired;
-       * re-evaluate after updating current ticks if needed
+      /* Process all of the watchdogs that became ready to run at or
+       * before this time.
        */
 
-      if (!clock_compare(wdog->expired, ticks))
+      while ((wdog = wd_pop_expired(ticks)) != NULL)
         {
-          next_ticks = wdog->expired;
-          break;
-        }
+          /* Indicate that the watchdog is no longer active. */
 
-      /* Remove the watchdog from the head of the list */
+          func = wdog->func;
+          arg  = wdog->arg;
+          wdog->func = NULL;
+          up_setpicbase(wdog->picbase);
 
-      list_delete_fast(&wdog->node);
-
-      /* Indicate that the watchdog is no longer active. */
-
-      func = wdog->func;
-      arg  = wdog->arg;
-      wdog->func = NULL;
+          /* Execute the watchdog function without the watchdog lock, it
+           * may start or cancel watchdogs.
+           */
 
-      /* Execute the watchdog function */
+          wd_set_running(wdog);
+          spin_unlock(&g_wdspinlock);
+          CALL_FUNC(func, arg);
+          spin_lock(&g_wdspinlock);
+          wd_set_running(NULL);
+        }
 
-      up_setpicbase(wdog->picbase);
-      CALL_FUNC(func, arg);
+      wd_set_nested(false);
     }
 
-  wd_set_nested(false);
+  if (!wd_list_is_empty())
+    {
+      next_ticks = wd_next_expire();
+    }
 
   if (next_ticks != ticks)
     {
       wd_timer_start(next_ticks, true);
     }
 
-  leave_critical_section(flags);
+  if (csection)
+    {
+      spin_unlock(&g_wdspinlock);
+      leave_critical_section(flags);
+    }
+  else
+    {
+      spin_unlock_irqrestore(&g_wdspinlock, flags);
+    }
 
   return next_ticks;
 }
@@ -185,6 +203,26 @@ static inline_function clock_t wd_expiration(clock_t ticks)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+static inline_function
+bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
+               wdentry_t wdentry, wdparm_t arg)
+{
+  bool    empty = wd_list_is_empty();
+  clock_t next  = empty ? expired : wd_next_expire();
+
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  wd_wheel_insert(wdog);
+
+  /* Return whether the next event of the wheel has changed. */
+
+  return empty || wd_next_expire() != next;
+}
+#else
 static inline_function
 bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
@@ -224,6 +262,7 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
 
   return head == curr;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -281,7 +320,7 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
        * the critical section is established.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave(&g_wdspinlock);
 
       /* If the wdog is canceling, restarting the wdog is not allowed. */
 
@@ -292,8 +331,15 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       if (WDOG_ISACTIVE(wdog))
         {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+          clock_t next = wd_next_expire();
+
+          wd_remove(wdog);
+          reassess |= wd_list_is_empty() || wd_next_expire() != next;
+#else
           reassess |= list_is_head(&g_wdactivelist, &wdog->node);
           list_delete_fast(&wdog->node);
+#endif
         }
 
       reassess |= wd_insert(wdog, ticks, wdentry, arg);
@@ -315,12 +361,12 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       if (WDOG_ISACTIVE(wdog))
         {
-          list_delete_fast(&wdog->node);
+          wd_remove(wdog);
         }
 
       wd_insert(wdog, ticks, wdentry, arg);
 #endif
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_wdspinlock, flags);
       sched_note_wdog(NOTE_WDOG_START, wdentry,
                       (FAR void *)(uintptr_t)ticks);
       ret = OK;
@@ -0,0 +1,365 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <limits.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/list.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WDOG_WHEEL_SHIFT(l)   ((l) * WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_BIT(i)     ((uint64_t)1 << (i))
+#define WDOG_WHEEL_WINDOW(t, l) \
+  ((uint64_t)(t) >> WDOG_WHEEL_SHIFT(l))
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct wd_wheel_s g_wdwheel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_place
+ *
+ * Description:
+ *   Put the watchdog on the lowest level whose slot window for
+ *   wdog->expired has not yet been reached by the wheel time.  Watchdogs
+ *   that have already expired go to the level 0 slot being processed,
+ *   watchdogs beyond the range of the wheel are parked in the last slot of
+ *   the top level and placed again when that slot is cascaded.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_place(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *slot;
+  clock_t               curr  = g_wdwheel.curr;
+  clock_t               delta = wdog->expired - curr;
+  uint64_t              index;
+  unsigned int          level = 0;
+
+  if (delta < WDOG_WHEEL_SIZE)
+    {
+      index = delta > 0 ? wdog->expired : curr;
+    }
+  else
+    {
+      for (level = 1; level < WDOG_WHEEL_LEVELS; level++)
+        {
+          delta = WDOG_WHEEL_WINDOW(wdog->expired, level) -
+                  WDOG_WHEEL_WINDOW(curr, level);
+          if (delta < WDOG_WHEEL_SIZE)
+            {
+              break;
+            }
+        }
+
+      if (level == WDOG_WHEEL_LEVELS)
+        {
+          level--;
+          delta = WDOG_WHEEL_SIZE - 1;
+        }
+
+      index = WDOG_WHEEL_WINDOW(curr, level) + delta;
+    }
+
+  index &= WDOG_WHEEL_MASK;
+  slot   = &g_wdwheel.slots[level][index];
+
+  /* Slots are initialized lazily, only the bitmap tells if they are
+   * in use.
+   */
+
+  if ((g_wdwheel.bitmap[level] & WDOG_WHEEL_BIT(index)) == 0)
+    {
+      g_wdwheel.bitmap[level] |= WDOG_WHEEL_BIT(index);
+      list_initialize(slot);
+    }
+
+  list_add_tail(slot, &wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Move the watchdogs of every upper level slot whose window starts at
+ *   the current wheel time down to the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(void)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s    *wdog;
+  clock_t               curr = g_wdwheel.curr;
+  unsigned int          level;
+  unsigned int          index;
+
+  for (level = WDOG_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      if (((uint64_t)curr & (WDOG_WHEEL_BIT(WDOG_WHEEL_SHIFT(level)) - 1))
+          != 0)
+        {
+          continue;
+        }
+
+      index = WDOG_WHEEL_WINDOW(curr, level) & WDOG_WHEEL_MASK;
+      if ((g_wdwheel.bitmap[level] & WDOG_WHEEL_BIT(index)) == 0)
+        {
+          continue;
+        }
+
+      /* The watchdogs of this slot can never be placed back into it, so
+       * it is safe to release the slot before walking it.
+       */
+
+      g_wdwheel.bitmap[level] &= ~WDOG_WHEEL_BIT(index);
+      slot = &g_wdwheel.slots[level][index];
+
+      while (!list_is_empty(slot))
+        {
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          list_delete_fast(&wdog->node);
+          wd_wheel_place(wdog);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Place a watchdog on the timing wheel according to wdog->expired.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to insert.  It must not be on the wheel.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  /* Nothing is pending, the wheel time can be moved to the current time
+   * so that the new watchdog does not have to be cascaded from stale
+   * windows.
+   */
+
+  if (g_wdwheel.count == 0 && !wd_in_callback())
+    {
+      clock_t now = clock_systime_ticks();
+
+      if (clock_compare(g_wdwheel.curr, now))
+        {
+          g_wdwheel.curr = now;
+        }
+    }
+
+  wd_wheel_place(wdog);
+  g_wdwheel.count++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timing wheel.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove.  It must be on the wheel.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  /* If the watchdog is the only entry, both of its links point to the
+   * slot head and the slot becomes empty.
+   */
+
+  if (list_is_singular(&wdog->node))
+    {
+      size_t index = wdog->node.next - &g_wdwheel.slots[0][0];
+
+      DEBUGASSERT(index < WDOG_WHEEL_LEVELS * WDOG_WHEEL_SIZE);
+      g_wdwheel.bitmap[index / WDOG_WHEEL_SIZE] &=
+        ~WDOG_WHEEL_BIT(index & WDOG_WHEEL_MASK);
+    }
+
+  list_delete_fast(&wdog->node);
+  g_wdwheel.count--;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the next tick at which the wheel needs attention, either to
+ *   expire watchdogs or to cascade an upper level slot.
+ *
+ * Returned Value:
+ *   The tick of the next wheel event.  The wheel must not be empty.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_next(void)
+{
+  clock_t      next  = CLOCK_MAX;
+  bool         found = false;
+  unsigned int level;
+
+  DEBUGASSERT(g_wdwheel.count > 0);
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      uint64_t bitmap = g_wdwheel.bitmap[level];
+      uint64_t window;
+      clock_t  tick;
+      int      rot;
+
+      if (bitmap == 0)
+        {
+          continue;
+        }
+
+      /* Level 0 starts at the slot being processed, the upper levels at
+       * the first window after the current one.
+       */
+
+      window = WDOG_WHEEL_WINDOW(g_wdwheel.curr, level) + (level > 0);
+      rot    = window & WDOG_WHEEL_MASK;
+      bitmap = (bitmap >> rot) | (bitmap << ((WDOG_WHEEL_SIZE - rot) &
+                                             WDOG_WHEEL_MASK));
+      window += ffsll(bitmap) - 1;
+      tick    = (clock_t)(window << WDOG_WHEEL_SHIFT(level));
+
+      if (!found || clock_compare(tick, next))
+        {
+          next  = tick;
+          found = true;
+        }
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_pop
+ *
+ * Description:
+ *   Advance the wheel up to 'ticks' and remove the next watchdog that has
+ *   expired at or before 'ticks'.
+ *
+ * Input Parameters:
+ *   ticks - The current time in clock ticks
+ *
+ * Returned Value:
+ *   The expired watchdog or NULL if there is none left.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_pop(clock_t ticks)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s    *wdog;
+  unsigned int          index;
+  clock_t               next;
+
+  while (clock_compare(g_wdwheel.curr, ticks))
+    {
+      /* Hand out the watchdogs of the current level 0 slot one by one, the
+       * callbacks may start or cancel other watchdogs in between.
+       */
+
+      index = g_wdwheel.curr & WDOG_WHEEL_MASK;
+      if ((g_wdwheel.bitmap[0] & WDOG_WHEEL_BIT(index)) != 0)
+        {
+          slot = &g_wdwheel.slots[0][index];
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          list_delete_fast(&wdog->node);
+          if (list_is_empty(slot))
+            {
+              g_wdwheel.bitmap[0] &= ~WDOG_WHEEL_BIT(index);
+            }
+
+          g_wdwheel.count--;
+          return wdog;
+        }
+
+      /* Jump to the next event, skipping the empty slots */
+
+      next = g_wdwheel.count > 0 ? wd_wheel_next() : ticks;
+      if (!clock_compare(next, ticks))
+        {
+          next = ticks;
+        }
+
+      if (next == g_wdwheel.curr)
+        {
+          break;
+        }
+
+      g_wdwheel.curr = next;
+      wd_wheel_cascade();
+    }
+
+  return NULL;
+}
@@ -37,6 +37,7 @@
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
 #include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_HRTIMER
 #  include <nuttx/hrtimer.h> 
@@ -46,6 +47,35 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#  define WDOG_WHEEL_BITS   6
+#  define WDOG_WHEEL_SIZE   (1 << WDOG_WHEEL_BITS)
+#  define WDOG_WHEEL_MASK   (WDOG_WHEEL_SIZE - 1)
+#  define WDOG_WHEEL_LEVELS CONFIG_WDOG_TIMERWHEEL_LEVELS
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* Hierarchical timing wheel.  Level n has WDOG_WHEEL_SIZE slots, each
+ * covering WDOG_WHEEL_SIZE^n ticks.  A watchdog is kept on the lowest
+ * level whose slot window has not yet been reached, and is moved down one
+ * or more levels (cascaded) when the wheel time reaches the start of that
+ * window.  The bitmap records the non-empty slots of every level so that
+ * the next event can be found without walking the slots.
+ */
+
+struct wd_wheel_s
+{
+  clock_t          curr;   /* Wheel time, level 0 slot being processed */
+  size_t           count;  /* Number of watchdogs on the wheel */
+  uint64_t         bitmap[WDOG_WHEEL_LEVELS];
+  struct list_node slots[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SIZE];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -63,7 +93,25 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+extern struct wd_wheel_s g_wdwheel;
+#else
 extern struct list_node g_wdactivelist;
+#endif
+
+/* g_wdspinlock protects the active watchdogs.  It nests inside of the
+ * critical section, never the other way around.
+ */
+
+extern spinlock_t g_wdspinlock;
+
+#ifdef CONFIG_SMP
+/* g_wdrunning holds the watchdog whose function runs on each CPU, so that
+ * wd_cancel() can wait for it to return.
+ */
+
+extern FAR struct wdog_s *volatile g_wdrunning[CONFIG_SMP_NCPUS];
+#endif
 
 #ifdef CONFIG_HRTIMER
 extern struct hrtimer_s g_wdtimer;
@@ -110,6 +158,84 @@ void wd_timer(clock_t ticks);
 uint64_t wd_timer(const hrtimer_t *timer, uint64_t expired);
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Place a watchdog on the timing wheel according to wdog->expired.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to insert.  It must not be on the wheel.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timing wheel.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove.  It must be on the wheel.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the next tick at which the wheel needs attention, either to
+ *   expire watchdogs or to cascade an upper level slot.
+ *
+ * Returned Value:
+ *   The tick of the next wheel event.  The wheel must not be empty.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_next(void);
+
+/****************************************************************************
+ * Name: wd_wheel_pop
+ *
+ * Description:
+ *   Advance the wheel up to 'ticks' and remove the next watchdog that has
+ *   expired at or before 'ticks'.
+ *
+ * Input Parameters:
+ *   ticks - The current time in clock ticks
+ *
+ * Returned Value:
+ *   The expired watchdog or NULL if there is none left.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_pop(clock_t ticks);
+#endif
+
 /****************************************************************************
  * Inline functions
  ****************************************************************************/
@@ -124,6 +250,12 @@ uint64_t wd_timer(const hrtimer_t *timer, uint64_t expired);
 #  define wd_update_expire(expired)
 #endif
 
+#ifdef CONFIG_SMP
+#  define wd_set_running(wdog)      (g_wdrunning[this_cpu()] = (wdog))
+#else
+#  define wd_set_running(wdog)
+#endif
+
 #ifdef CONFIG_HRTIMER
 static inline_function void wd_timer_start(clock_t tick, bool in_expiration)
 {
@@ -194,9 +326,57 @@ static inline_function void wd_timer_cancel(void)
 #  define wd_timer_cancel()
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#  define wd_list_is_empty() (g_wdwheel.count == 0)
+#else
+#  define wd_list_is_empty() list_is_empty(&g_wdactivelist)
+#endif
+
+static inline_function void wd_remove(FAR struct wdog_s *wdog)
+{
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  wd_wheel_remove(wdog);
+#else
+  list_delete_fast(&wdog->node);
+#endif
+}
+
 static inline_function clock_t wd_next_expire(void)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  return wd_wheel_next();
+#else
   return list_first_entry(&g_wdactivelist, struct wdog_s, node)->expired;
+#endif
+}
+
+/* Return true if a watchdog may have expired at or before 'ticks' */
+
+static inline_function bool wd_has_expired(clock_t ticks)
+{
+  return !wd_list_is_empty() && clock_compare(wd_next_expire(), ticks);
+}
+
+/* Remove and return the next watchdog that has expired at or before
+ * 'ticks', or NULL if there is none.
+ */
+
+static inline_function FAR struct wdog_s *wd_pop_expired(clock_t ticks)
+{
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  return wd_wheel_pop(ticks);
+#else
+  FAR struct wdog_s *wdog;
+
+  if (!wd_has_expired(ticks))
+    {
+      return NULL;
+    }
+
+  wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
+  list_delete_fast(&wdog->node);
+  return wdog;
+#endif
 }
 
 /****************************************************************************
@@ -206,14 +386,14 @@ static inline_function clock_t wd_next_expire(void)
 static inline_function clock_t wd_get_next_expire(clock_t curr)
 {
   clock_t     next = curr;
-  irqstate_t flags = enter_critical_section();
+  irqstate_t flags = spin_lock_irqsave(&g_wdspinlock);
 
-  if (!list_is_empty(&g_wdactivelist))
+  if (!wd_list_is_empty())
     {
       next = wd_next_expire();
     }
 
-  leave_critical_section(flags);
+  spin_unlock_irqrestore(&g_wdspinlock, flags);
   return next - curr <= 0 ? 0 : next;
 }
 
@@ -56,12 +56,18 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
   /* Cancelling the work is simply a matter of removing the work structure
    * from the work queue.  This must be done with interrupts disabled because
    * new work is typically added to the work queue from interrupt handlers.
+   * The work may still be in the lock-free inbox of any queue.
    */
 
+  work_inbox_flush(work);
   flags = spin_lock_irqsave(&wqueue->lock);
 
   if (!work_available(work))
     {
+      /* The work may have been submitted to the inbox meanwhile */
+
+      work_inbox_drain(wqueue);
+
       /* If the head of the pending queue has changed, we should reset
        * the wqueue timer.
        */
@@ -70,6 +76,8 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
         {
           work_timer_reset(wqueue);
         }
+
+      work_stats_cancel(wqueue);
     }
 
   /* Note that cancel_sync can not be called in the interrupt
@@ -174,4 +182,36 @@ int work_cancel_sync_wq(FAR struct kwork_wqueue_s *wqueue,
   return work_qcancel(wqueue, true, work);
 }
 
+/****************************************************************************
+ * Name: work_cancel_on/work_cancel_sync_on
+ *
+ * Description:
+ *   Cancel work previously queued on the per-CPU work queue of the CPU
+ *   'cpu' with work_queue_on().  work_cancel_sync_on() also waits for the
+ *   work to complete if it is running.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU the work was queued on
+ *   work   - The previously queued work structure to cancel
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ *   -ENOENT - There is no such work queued.
+ *   -EINVAL - An invalid CPU was specified
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PCPUWORK
+int work_cancel_on(int cpu, FAR struct work_s *work)
+{
+  return work_qcancel(work_cpu2wq(cpu), false, work);
+}
+
+int work_cancel_sync_on(int cpu, FAR struct work_s *work)
+{
+  return work_qcancel(work_cpu2wq(cpu), true, work);
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
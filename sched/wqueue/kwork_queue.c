@@ -87,6 +87,8 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
 
   flags = spin_lock_irqsave(&wqueue->lock);
 
+  work_stats_queue(wqueue);
+
   if (delay)
     {
       /* Insert to the pending list of the wqueue. */
@@ -160,7 +162,8 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 {
   irqstate_t flags;
   clock_t expected;
-  bool retimer;
+  bool retimer = false;
+  bool queued;
 
   if (wqueue == NULL || work == NULL || worker == NULL ||
       delay > WDOG_MAX_DELAY)
@@ -170,6 +173,21 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 
   expected = clock_delay2abstick(delay);
 
+#ifdef CONFIG_WQUEUE_LOCKFREE
+  /* Immediate work that is not queued yet goes to the lock-free inbox */
+
+  if (delay == 0 &&
+      work_inbox_submit(wqueue, work, worker, arg, expected))
+    {
+      nxsem_post(&wqueue->sem);
+      return 0;
+    }
+#endif
+
+  /* A work queued before may still be in the inbox of another queue */
+
+  work_inbox_flush(work);
+
   /* Interrupts are disabled so that this logic can be called from with
    * task logic or from interrupt handling logic.
    */
@@ -178,7 +196,29 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 
   /* Ensure the work has been removed. */
 
-  retimer = work_available(work) ? false : work_remove(wqueue, work);
+#ifdef CONFIG_WQUEUE_LOCKFREE
+  /* Claim the work so that it cannot be submitted to the inbox meanwhile.
+   * If it is already queued, it may still be in the inbox.
+   */
+
+  queued = !work_claim(work, worker);
+  if (queued)
+    {
+      work_inbox_drain(wqueue);
+      retimer = work_unlink(wqueue, work);
+    }
+#else
+  queued = !work_available(work);
+  if (queued)
+    {
+      retimer = work_remove(wqueue, work);
+    }
+#endif
+
+  if (!queued)
+    {
+      work_stats_queue(wqueue);
+    }
 
   /* Initialize the work structure. */
 
@@ -229,4 +269,32 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
   return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
 }
 
+/****************************************************************************
+ * Name: work_queue_on
+ *
+ * Description:
+ *   Queue work to be performed by the worker thread bound to the CPU
+ *   'cpu'.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU that shall perform the work
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PCPUWORK
+int work_queue_on(int cpu, FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay)
+{
+  return work_queue_wq(work_cpu2wq(cpu), work, worker, arg, delay);
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -112,6 +112,20 @@ struct lp_wqueue_s g_lpwork =
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+#ifdef CONFIG_SCHED_PCPUWORK
+/* The state of the kernel mode, per-CPU work queues.  They are initialized
+ * by work_start_pcpu().
+ */
+
+struct pcpu_wqueue_s g_pcpuwork[CONFIG_SMP_NCPUS];
+#endif
+
+#ifdef CONFIG_WQUEUE_STATS
+/* The list of all work queues, for procfs */
+
+struct list_node g_wqueue_list = LIST_INITIAL_VALUE(g_wqueue_list);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -122,7 +136,24 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
   FAR struct work_s *work;
   FAR struct work_s *next;
   unsigned int count = 0;
-  clock_t      ticks = clock_systime_ticks();
+  clock_t      ticks;
+
+  /* Move the immediate work submitted to the lock-free inbox to the
+   * expired queue, in one batch.
+   */
+
+  work_inbox_drain(wq);
+
+  /* If the wqueue timer is expired and non-active, it indicates that
+   * there might be expired work in the pending queue.
+   */
+
+  if (WDOG_ISACTIVE(&wq->timer))
+    {
+      return;
+    }
+
+  ticks = clock_systime_ticks();
 
   /* Wake up the worker thread once there is expired work.
    * If some worker threads are busy, here the callback will
@@ -213,20 +244,14 @@ static int work_thread(int argc, FAR char *argv[])
 
        flags = spin_lock_irqsave_nopreempt(&wqueue->lock);
 
-      /* If the wqueue timer is expired and non-active, it indicates that
-       * there might be expired work in the pending queue.
-       */
-
-      if (!WDOG_ISACTIVE(&wqueue->timer))
-        {
-          work_dispatch(wqueue);
-        }
+      work_dispatch(wqueue);
 
       if (!list_is_empty(&wqueue->expired))
         {
           work = list_first_entry(&wqueue->expired, struct work_s, node);
 
           list_delete(&work->node);
+          work_stats_run(wqueue, work);
 
           /* Extract the work description from the entry (in case the
            * work instance will be reused after it has been de-queued).
@@ -303,6 +328,9 @@ static int work_thread_create(FAR const char *name, int priority,
                               FAR struct kwork_wqueue_s *wqueue)
 {
   FAR struct kworker_s *worker = wq_get_worker(wqueue);
+#ifdef CONFIG_WQUEUE_STATS
+  irqstate_t flags;
+#endif
   FAR char *argv[3];
   char arg0[32];
   char arg1[32];
@@ -347,6 +375,12 @@ static int work_thread_create(FAR const char *name, int priority,
       worker[wndx].pid = pid;
     }
 
+#ifdef CONFIG_WQUEUE_STATS
+  flags = enter_critical_section();
+  list_add_tail(&g_wqueue_list, &wqueue->stats.link);
+  leave_critical_section(flags);
+#endif
+
   sched_unlock();
   return OK;
 }
@@ -460,6 +494,9 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
 
 int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 {
+#ifdef CONFIG_WQUEUE_STATS
+  irqstate_t flags;
+#endif
   int wndx;
 
   if (wqueue == NULL)
@@ -469,6 +506,12 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 
   wd_cancel(&wqueue->timer);
 
+#ifdef CONFIG_WQUEUE_STATS
+  flags = enter_critical_section();
+  list_delete(&wqueue->stats.link);
+  leave_critical_section(flags);
+#endif
+
   /* Mark the work queue as exiting */
 
   wqueue->exit = true;
@@ -617,4 +660,69 @@ int work_start_lowpri(void)
 }
 #endif /* CONFIG_SCHED_LPWORK */
 
+/****************************************************************************
+ * Name: work_start_pcpu
+ *
+ * Description:
+ *   Start the per-CPU, kernel-mode worker threads, one bound to each CPU.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Return zero (OK) on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PCPUWORK
+int work_start_pcpu(void)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  cpu_set_t cpuset;
+  char name[CONFIG_TASK_NAME_SIZE + 1];
+  int cpu;
+  int ret;
+
+  /* Start the per-CPU, kernel mode worker threads */
+
+  sinfo("Starting per-CPU kernel worker threads\n");
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      wqueue = (FAR struct kwork_wqueue_s *)&g_pcpuwork[cpu];
+
+      list_initialize(&wqueue->expired);
+      list_initialize(&wqueue->pending);
+      nxsem_init(&wqueue->sem, 0, 0);
+      nxsem_init(&wqueue->exsem, 0, 0);
+      spin_lock_init(&wqueue->lock);
+      wqueue->nthreads = 1;
+
+      snprintf(name, sizeof(name), PCPUWORKNAME "%d", cpu);
+      ret = work_thread_create(name, CONFIG_SCHED_PCPUWORKPRIORITY, NULL,
+                               CONFIG_SCHED_PCPUWORKSTACKSIZE, wqueue);
+      if (ret < 0)
+        {
+          wqueue->nthreads = 0;
+          return ret;
+        }
+
+      /* Bind the worker thread to its CPU */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+      ret = nxsched_set_affinity(g_pcpuwork[cpu].worker[0].pid,
+                                 sizeof(cpu_set_t), &cpuset);
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to bind %s: %d\n", name, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif /* CONFIG_SCHED_PCPUWORK */
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -32,7 +32,9 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/list.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/spinlock.h>
@@ -47,6 +49,7 @@
 
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
+#define PCPUWORKNAME "pcpuwork"
 
 /* Get the worker structure from the work queue.
  * This function requires the workers are located next to the wqueue.
@@ -55,6 +58,14 @@
 #define wq_get_worker(wq) \
   (FAR struct kworker_s *)((FAR char *)(wq) + sizeof(struct kwork_wqueue_s))
 
+#ifdef CONFIG_WQUEUE_LOCKFREE
+#  define WQUEUE_INBOX_MASK (CONFIG_WQUEUE_LOCKFREE_NENTRIES - 1)
+
+#  if (CONFIG_WQUEUE_LOCKFREE_NENTRIES & WQUEUE_INBOX_MASK) != 0
+#    error CONFIG_WQUEUE_LOCKFREE_NENTRIES must be a power of two
+#  endif
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -69,6 +80,35 @@ struct kworker_s
   int16_t           wait_count;
 };
 
+#ifdef CONFIG_WQUEUE_LOCKFREE
+/* This is one entry of the lock-free inbox.  The sequence number of an
+ * entry tells whether it is free or holds a submitted work for the current
+ * lap around the inbox:  For position 'pos', the entry is free when its
+ * sequence is the lap base (pos & ~WQUEUE_INBOX_MASK) and holds a work
+ * when it is the lap base plus one.  A zeroed inbox is empty.
+ */
+
+struct kwork_slot_s
+{
+  atomic_t          seq;       /* Entry sequence number */
+  FAR struct work_s *work;     /* Submitted work or NULL */
+};
+#endif
+
+#ifdef CONFIG_WQUEUE_STATS
+/* This structure holds the statistics of one work queue */
+
+struct kwork_stats_s
+{
+  struct list_node  link;      /* Link in the list of work queues */
+  atomic_t          depth;     /* Number of queued works */
+  uint32_t          maxdepth;  /* Maximum number of queued works */
+  uint32_t          count;     /* Number of works run */
+  clock_t           maxlat;    /* Maximum latency in ticks */
+  uint64_t          totlat;    /* Sum of latencies in ticks */
+};
+#endif
+
 /* This structure defines the state of one kernel-mode work queue */
 
 struct kwork_wqueue_s
@@ -81,6 +121,14 @@ struct kwork_wqueue_s
   uint8_t          nthreads;  /* Number of worker threads */
   bool             exit;      /* A flag to request the thread to exit */
   struct wdog_s    timer;     /* Timer to pending. */
+#ifdef CONFIG_WQUEUE_LOCKFREE
+  atomic_t         tail;      /* Next inbox position to submit */
+  uint32_t         head;      /* Next inbox position to drain */
+  struct kwork_slot_s inbox[CONFIG_WQUEUE_LOCKFREE_NENTRIES];
+#endif
+#ifdef CONFIG_WQUEUE_STATS
+  struct kwork_stats_s stats; /* Work queue statistics */
+#endif
 };
 
 /* This structure defines the state of one high-priority work queue.  This
@@ -113,6 +161,21 @@ struct lp_wqueue_s
 };
 #endif
 
+/* This structure defines the state of one per-CPU work queue.  This
+ * structure must be cast compatible with kwork_wqueue_s
+ */
+
+#ifdef CONFIG_SCHED_PCPUWORK
+struct pcpu_wqueue_s
+{
+  struct kwork_wqueue_s wq;
+
+  /* Describes the single thread bound to the CPU */
+
+  struct kworker_s      worker[1];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -129,6 +192,18 @@ extern struct hp_wqueue_s g_hpwork;
 extern struct lp_wqueue_s g_lpwork;
 #endif
 
+#ifdef CONFIG_SCHED_PCPUWORK
+/* The state of the kernel mode, per-CPU work queues. */
+
+extern struct pcpu_wqueue_s g_pcpuwork[CONFIG_SMP_NCPUS];
+#endif
+
+#ifdef CONFIG_WQUEUE_STATS
+/* The list of all work queues, for procfs */
+
+extern struct list_node g_wqueue_list;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -154,6 +229,28 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
     }
 }
 
+/****************************************************************************
+ * Name: work_cpu2wq
+ *
+ * Description:
+ *   Return the per-CPU work queue of the CPU 'cpu', or NULL if the CPU is
+ *   not valid or its work queue is not started yet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PCPUWORK
+static inline_function FAR struct kwork_wqueue_s *work_cpu2wq(int cpu)
+{
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS ||
+      g_pcpuwork[cpu].wq.nthreads == 0)
+    {
+      return NULL;
+    }
+
+  return (FAR struct kwork_wqueue_s *)&g_pcpuwork[cpu];
+}
+#endif
+
 /****************************************************************************
  * Name: work_insert_pending
  *
@@ -210,11 +307,12 @@ bool work_insert_pending(FAR struct kwork_wqueue_s *wqueue,
 }
 
 /****************************************************************************
- * Name: work_remove
+ * Name: work_remove/work_unlink
  *
  * Description:
  *   Internal public function to remove the work from the workqueue.
- *   Require wqueue != NULL and work != NULL.
+ *   Require wqueue != NULL and work != NULL.  work_unlink() leaves the
+ *   work owned by the caller (work->worker is not cleared).
  *
  * Input Parameters:
  *   wqueue - The work queue.
@@ -226,22 +324,267 @@ bool work_insert_pending(FAR struct kwork_wqueue_s *wqueue,
  ****************************************************************************/
 
 static inline_function
-bool work_remove(FAR struct kwork_wqueue_s *wqueue,
+bool work_unlink(FAR struct kwork_wqueue_s *wqueue,
                  FAR struct work_s         *work)
 {
   FAR struct work_s *head;
 
   head = list_first_entry(&wqueue->pending, struct work_s, node);
 
-  /* Seize the ownership from the work thread. */
+  /* A work still in the lock-free inbox of another queue is not linked */
 
-  work->worker = NULL;
+  if (work->node.next == NULL)
+    {
+      return false;
+    }
 
   list_delete(&work->node);
 
   return head == work;
 }
 
+static inline_function
+bool work_remove(FAR struct kwork_wqueue_s *wqueue,
+                 FAR struct work_s         *work)
+{
+  /* Seize the ownership from the work thread. */
+
+  work->worker = NULL;
+
+  return work_unlink(wqueue, work);
+}
+
+/****************************************************************************
+ * Name: work_stats_*
+ *
+ * Description:
+ *   Account a work entering the queue, leaving it without running and
+ *   starting to run.  work_stats_run() is called with the wqueue lock held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_STATS
+static inline_function void work_stats_queue(FAR struct kwork_wqueue_s *wq)
+{
+  atomic_fetch_add(&wq->stats.depth, 1);
+}
+
+static inline_function void work_stats_cancel(FAR struct kwork_wqueue_s *wq)
+{
+  atomic_fetch_sub(&wq->stats.depth, 1);
+}
+
+static inline_function void work_stats_run(FAR struct kwork_wqueue_s *wq,
+                                           FAR struct work_s *work)
+{
+  FAR struct kwork_stats_s *stats = &wq->stats;
+  uint32_t depth = (uint32_t)atomic_fetch_sub(&stats->depth, 1);
+  clock_t latency = clock_systime_ticks() - work->qtime;
+
+  if (latency < 0)
+    {
+      latency = 0;
+    }
+
+  if (depth > stats->maxdepth)
+    {
+      stats->maxdepth = depth;
+    }
+
+  if (latency > stats->maxlat)
+    {
+      stats->maxlat = latency;
+    }
+
+  stats->totlat += latency;
+  stats->count++;
+}
+#else
+#  define work_stats_queue(wq)
+#  define work_stats_cancel(wq)
+#  define work_stats_run(wq, work)
+#endif
+
+#ifdef CONFIG_WQUEUE_LOCKFREE
+
+/****************************************************************************
+ * Name: work_claim
+ *
+ * Description:
+ *   Take the ownership of an available work by setting its worker
+ *   atomically.  Fails if the work is already queued.
+ *
+ ****************************************************************************/
+
+static inline_function bool work_claim(FAR struct work_s *work,
+                                       worker_t worker)
+{
+#if UINTPTR_MAX <= UINT32_MAX
+  int32_t expected = 0;
+
+  return atomic_try_cmpxchg_acquire((FAR atomic_t *)&work->worker,
+                                    &expected, (int32_t)(uintptr_t)worker);
+#else
+  int64_t expected = 0;
+
+  return atomic64_try_cmpxchg_acquire((FAR atomic64_t *)&work->worker,
+                                      &expected,
+                                      (int64_t)(uintptr_t)worker);
+#endif
+}
+
+/****************************************************************************
+ * Name: work_inbox_submit
+ *
+ * Description:
+ *   Submit immediate work to the lock-free inbox of the work queue.  An
+ *   inbox entry is reserved before the work is claimed so that
+ *   work_inbox_drain() can find every claimed work below the tail.  Local
+ *   interrupts are disabled to keep the reservation short; no lock is
+ *   taken.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work to submit.
+ *   worker - The worker callback.
+ *   arg    - The argument of the callback.
+ *   qtime  - The expected execution time.
+ *
+ * Returned Value:
+ *   True if the work was submitted.  False if the inbox is full or the
+ *   work is already queued; the locked path must be used instead.
+ *
+ ****************************************************************************/
+
+static inline_function
+bool work_inbox_submit(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, clock_t qtime)
+{
+  FAR struct kwork_slot_s *slot;
+  irqstate_t flags;
+  uint32_t base;
+  int32_t diff;
+  int32_t pos;
+  bool ret = false;
+
+  flags = up_irq_save();
+
+  /* Reserve the entry at the tail of the inbox */
+
+  pos = atomic_read(&wqueue->tail);
+  for (; ; )
+    {
+      slot = &wqueue->inbox[pos & WQUEUE_INBOX_MASK];
+      base = (uint32_t)pos & ~WQUEUE_INBOX_MASK;
+      diff = (int32_t)((uint32_t)atomic_read_acquire(&slot->seq) - base);
+      if (diff == 0)
+        {
+          if (atomic_try_cmpxchg_relaxed(&wqueue->tail, &pos,
+                                         (int32_t)((uint32_t)pos + 1)))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          /* The inbox is full */
+
+          up_irq_restore(flags);
+          return false;
+        }
+      else
+        {
+          pos = atomic_read(&wqueue->tail);
+        }
+    }
+
+  /* Claim the work and publish it, or publish an empty entry */
+
+  slot->work = NULL;
+  if (work_claim(work, worker))
+    {
+      work->arg   = arg;
+      work->qtime = qtime;
+      work->inbox = wqueue;
+      slot->work  = work;
+      work_stats_queue(wqueue);
+      ret = true;
+    }
+
+  atomic_set_release(&slot->seq, (int32_t)(base + 1));
+  up_irq_restore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: work_inbox_drain
+ *
+ * Description:
+ *   Move all works of the lock-free inbox to the tail of the expired
+ *   queue.  Called with the wqueue lock held.  An entry that is reserved
+ *   but not yet published belongs to a producer on another CPU that runs
+ *   with interrupts disabled, so it is waited for.
+ *
+ ****************************************************************************/
+
+static inline_function void work_inbox_drain(FAR struct kwork_wqueue_s *wq)
+{
+  FAR struct kwork_slot_s *slot;
+  FAR struct work_s *work;
+  uint32_t base;
+
+  while ((int32_t)wq->head != atomic_read_acquire(&wq->tail))
+    {
+      slot = &wq->inbox[wq->head & WQUEUE_INBOX_MASK];
+      base = wq->head & ~WQUEUE_INBOX_MASK;
+
+      while ((uint32_t)atomic_read_acquire(&slot->seq) != base + 1)
+        {
+          /* Wait for the producer to publish the entry */
+        }
+
+      work = slot->work;
+      atomic_set_release(&slot->seq,
+                         (int32_t)(base + CONFIG_WQUEUE_LOCKFREE_NENTRIES));
+      wq->head++;
+
+      if (work != NULL)
+        {
+          work->inbox = NULL;
+          list_add_tail(&wq->expired, &work->node);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: work_inbox_flush
+ *
+ * Description:
+ *   Drain the inbox still holding the work, under the lock of its queue,
+ *   so that the work is linked to a list before it is unlinked.  The work
+ *   may be requeued or cancelled through another queue than the one it
+ *   was submitted to.  Called without any wqueue lock held.
+ *
+ ****************************************************************************/
+
+static inline_function void work_inbox_flush(FAR struct work_s *work)
+{
+  FAR struct kwork_wqueue_s *wq = work->inbox;
+  irqstate_t flags;
+
+  if (wq != NULL)
+    {
+      flags = spin_lock_irqsave(&wq->lock);
+      work_inbox_drain(wq);
+      spin_unlock_irqrestore(&wq->lock, flags);
+    }
+}
+#else
+#  define work_inbox_drain(wq)
+#  define work_inbox_flush(work)
+#endif /* CONFIG_WQUEUE_LOCKFREE */
+
 /****************************************************************************
  * Name: work_timer_expired
  *
@@ -326,6 +669,25 @@ int work_start_highpri(void);
 int work_start_lowpri(void);
 #endif
 
+/****************************************************************************
+ * Name: work_start_pcpu
+ *
+ * Description:
+ *   Start the per-CPU, kernel-mode worker threads, one bound to each CPU.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Return zero (OK) on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PCPUWORK
+int work_start_pcpu(void);
+#endif
+
 /****************************************************************************
  * Name: work_initialize_notifier
  *
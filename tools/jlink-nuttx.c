@@ -89,7 +89,7 @@ enum symbol_e
   PIDHASH = 0,
   NPIDHASH,
   TCBINFO,
-  READYTORUN,
+  RUNNINGTASKS,
   NSYMBOLS
 };
 
@@ -177,7 +177,7 @@ static struct symbols_s g_symbols[] =
   {"g_pidhash",            0, 0},
   {"g_npidhash",           0, 0},
   {"g_tcbinfo",            0, 0},
-  {"g_readytorun",         0, 0},
+  {"g_running_tasks",      0, 0},
   { NULL,                  0, 0}
 };
 
@@ -433,17 +433,22 @@ static int normalize_tcb(struct plugin_priv_s *priv)
         }
     }
 
-  ret = READU32(g_symbols[READYTORUN].address, &tcbaddr);
+  /* g_readytorun is one list per CPU with CONFIG_SCHED_PERCPU_RUNQUEUE and
+   * does not hold the running tasks in SMP, g_running_tasks[] holds them in
+   * every configuration.  Report the task running on CPU0.
+   */
+
+  ret = READU32(g_symbols[RUNNINGTASKS].address, &tcbaddr);
   if (ret != 0)
     {
-      PERROR("read readytorun error return %d\n", ret);
+      PERROR("read running tasks error return %d\n", ret);
       return ret;
     }
 
   ret = READU16(tcbaddr + priv->tcbinfo->pid_off, &priv->running);
   if (ret != 0)
     {
-      PERROR("read readytorun pid error return %d\n", ret);
+      PERROR("read running task pid error return %d\n", ret);
       return ret;
     }
 
@@ -88,6 +88,17 @@ class MMCheck(gdb.Command):
                         f"flink not intact: {hex(node.flink.blink)}, node: {hex(node.address)}",
                     )
 
+                if heap.segfit:
+                    # The segregated lists are not sorted, and their first
+                    # node has no blink.
+                    if node.blink and node.blink.flink != node:
+                        return (
+                            True,
+                            f"blink not intact: {hex(node.blink.flink)}, node: {hex(node.address)}",
+                        )
+
+                    return False, ""
+
                 if node.blink.flink != node:
                     return (
                         True,
@@ -122,7 +133,7 @@ class MMCheck(gdb.Command):
                     issues[node.address].append(reason)
 
             # Check free list
-            for node in utils.ArrayIterator(heap.mm_nodelist):
+            for node in heap.free_lists():
                 # node is in type of gdb.Value, struct mm_freenode_s
                 while node:
                     address = int(node.address)
@@ -580,6 +580,23 @@ class MMHeap(Value, p.MMHeap):
     def nodes_free(self) -> Generator[MMNode, None, None]:
         return filter(lambda node: node.is_free, self.nodes)
 
+    @property
+    def segfit(self) -> bool:
+        # CONFIG_MM_HEAP_SEGFIT replaces mm_nodelist by segregated free lists
+        return utils.has_field(self.type, "mm_freelist")
+
+    def free_lists(self) -> Generator[Value, None, None]:
+        """The first node of each free list, struct mm_freenode_s"""
+        if not self.segfit:
+            # The node table entries are the list heads, with size 0
+            yield from utils.ArrayIterator(self.mm_nodelist)
+            return
+
+        for sublists in utils.ArrayIterator(self.mm_freelist):
+            for head in utils.ArrayIterator(sublists):
+                if head:
+                    yield head.dereference()
+
     def nodes_used(self) -> Generator[MMNode, None, None]:
         return filter(lambda node: not node.is_free, self.nodes)
 
@@ -67,7 +67,10 @@ class MMHeap(Value):
     mm_heapstart: List[MMAllocNode]
     mm_heapend: List[MMAllocNode]
     mm_nregions: Value
-    mm_nodelist: Value
+    mm_nodelist: Value  # Without CONFIG_MM_HEAP_SEGFIT
+    mm_flbitmap: Value  # With CONFIG_MM_HEAP_SEGFIT
+    mm_slbitmap: Value
+    mm_freelist: Value
 
 
 class MemPool(Value):